@@ -19,9 +19,12 @@
 
 #include <stdio.h>
 
+#include "imu_calib.h"
 #include "key.h"
 #include "max30102_user.h"
 #include "oled_user.h"
+#include "step_count.h"
+#include "step_log.h"
 #include "uart_user.h"
 #include "atgm336h.h"
 
@@ -57,6 +60,38 @@ static void Task_SystemMonitor(void)
 }
 #endif
 
+// 静止时的省电策略：暂停 GPS 解析，降低 OLED 刷新率
+#define POWER_POLICY_PERIOD_MS 1000
+#define POWER_STILL_HOLD_MS 5000  // 持续静止该时间后才进入省电策略，运动时立即退出
+#define OLED_PERIOD_ACTIVE_MS 100
+#define OLED_PERIOD_STILL_MS 500
+
+/**
+ * @brief 根据活动分类调整其他任务的运行方式
+ */
+static void Task_PowerPolicy(void) {
+    static bool power_saving = false;
+    static uint32_t still_since = 0;
+    ActivityResult_t activity;
+    uint32_t now = HAL_GetTick();
+
+    StepCount_GetActivity(&activity);
+    if (activity.e_class != ACTIVITY_STILL) {
+        still_since = now;
+        if (power_saving) {
+            power_saving = false;
+            TaskScheduler_ResumeTask("GPS_Parse_Task");
+            TaskScheduler_SetPeriod("OLED_Task", OLED_PERIOD_ACTIVE_MS);
+        }
+        return;
+    }
+    if (!power_saving && now - still_since >= POWER_STILL_HOLD_MS) {
+        power_saving = true;
+        TaskScheduler_SuspendTask("GPS_Parse_Task");
+        TaskScheduler_SetPeriod("OLED_Task", OLED_PERIOD_STILL_MS);
+    }
+}
+
 /**
  * @brief 应用任务初始化
  */
@@ -67,10 +102,21 @@ void AppTasks_Init(void) {
     /* 参数：任务函数, 执行周期(ms), 优先级, 任务名称 */
     TaskScheduler_AddTask(Task_BLE_DataReceiveProc, 10, TASK_PRIORITY_HIGH, "BLE_Receive_Task");
     TaskScheduler_AddTask(Task_KeyProc, 20, TASK_PRIORITY_HIGH, "Key_Task");
-    TaskScheduler_AddTask(Task_OLED_Update, 100, TASK_PRIORITY_NORMAL, "OLED_Task");
+    TaskScheduler_AddTask(Task_OLED_Update, OLED_PERIOD_ACTIVE_MS, TASK_PRIORITY_NORMAL,
+                          "OLED_Task");
+    TaskScheduler_AddTask(Task_OLED_Power, OLED_POWER_TASK_PERIOD_MS, TASK_PRIORITY_NORMAL,
+                          "OLED_Power_Task");
     TaskScheduler_AddTask(Task_BloodMeasure, 20, TASK_PRIORITY_NORMAL, "Blood_Measure_Task");
-    TaskScheduler_SuspendTask("Blood_Measure_Task"); // 初始时暂停血氧测量任务
+    MAX30102_Suspend(); // 初始时暂停血氧测量任务并关断传感器
     TaskScheduler_AddTask(parseGpsBuffer, 20, TASK_PRIORITY_NORMAL, "GPS_Parse_Task");
+    TaskScheduler_AddTask(Task_StepPower, STEP_POWER_TASK_PERIOD_MS, TASK_PRIORITY_NORMAL,
+                          "Step_Power_Task");
+    TaskScheduler_AddTask(Task_StepLog, STEP_LOG_TASK_PERIOD_MS, TASK_PRIORITY_LOW,
+                          "Step_Log_Task");
+    TaskScheduler_AddTask(Task_ImuCalib, IMU_CALIB_TASK_PERIOD_MS, TASK_PRIORITY_LOW,
+                          "IMU_Calib_Task");
+    TaskScheduler_AddTask(Task_PowerPolicy, POWER_POLICY_PERIOD_MS, TASK_PRIORITY_LOW,
+                          "Power_Policy_Task");
     // TaskScheduler_AddTask(Task_SystemMonitor, 1000, TASK_PRIORITY_NORMAL, "Monitor_Task");
     /* 输出任务信息 */
     // printf("Task Scheduler Initialized with %d tasks\r\n", TaskScheduler_GetTaskCount());
@@ -0,0 +1,33 @@
+/**
+ * @file cycle_counter.h
+ * @author Shiki
+ * @brief DWT cycle counter helpers for on-target benchmarking.
+ *        Remember to call CycleCounter_Init() once before reading the counter!!!
+ * @version 0.1
+ * @date 2025-10-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __CYCLE_COUNTER_H
+#define __CYCLE_COUNTER_H
+
+#include "main.h"
+
+/**
+ * @brief 使能 DWT 周期计数器（72MHz 下约 59s 回绕一次）
+ */
+static inline void CycleCounter_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief 读取当前周期计数，两次读数相减即为耗时（无符号相减可自动处理回绕）
+ */
+static inline uint32_t CycleCounter_Get(void) {
+    return DWT->CYCCNT;
+}
+
+#endif /* __CYCLE_COUNTER_H */
@@ -0,0 +1,73 @@
+/**
+ * @file int_math.h
+ * @author Shiki
+ * @brief Integer square root and squared vector magnitude shared by the sensor algorithms.
+ *        No dependency on the HAL, so the algorithm files that use it still build on the host.
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __INT_MATH_H
+#define __INT_MATH_H
+
+#include <stdint.h>
+
+/**
+ * @brief 整数平方根（向下取整），逐位计算
+ */
+static inline uint32_t isqrt32(uint32_t un_x) {
+    uint32_t un_res = 0;
+    uint32_t un_bit = 1UL << 30;
+
+    while (un_bit > un_x)
+        un_bit >>= 2;
+    while (un_bit != 0) {
+        if (un_x >= un_res + un_bit) {
+            un_x -= un_res + un_bit;
+            un_res = (un_res >> 1) + un_bit;
+        } else {
+            un_res >>= 1;
+        }
+        un_bit >>= 2;
+    }
+    return un_res;
+}
+
+/**
+ * @brief 64 位整数平方根（向下取整），结果不超过 32 位
+ */
+static inline uint32_t isqrt64(uint64_t ul_x) {
+    uint64_t ul_res = 0;
+    uint64_t ul_bit = (uint64_t)1 << 62;
+
+    while (ul_bit > ul_x)
+        ul_bit >>= 2;
+    while (ul_bit != 0) {
+        if (ul_x >= ul_res + ul_bit) {
+            ul_x -= ul_res + ul_bit;
+            ul_res = (ul_res >> 1) + ul_bit;
+        } else {
+            ul_res >>= 1;
+        }
+        ul_bit >>= 2;
+    }
+    return (uint32_t)ul_res;
+}
+
+/**
+ * @brief 两轴原始值的模平方，最大 2 * 2^30，不会溢出
+ */
+static inline uint32_t mag_sq2(int16_t w_a, int16_t w_b) {
+    return (uint32_t)((int32_t)w_a * w_a) + (uint32_t)((int32_t)w_b * w_b);
+}
+
+/**
+ * @brief 三轴原始值的模平方，最大 3 * 2^30，不会溢出
+ */
+static inline uint32_t mag_sq3(int16_t w_x, int16_t w_y, int16_t w_z) {
+    return mag_sq2(w_x, w_y) + (uint32_t)((int32_t)w_z * w_z);
+}
+
+#endif /* __INT_MATH_H */
@@ -0,0 +1,74 @@
+/**
+ * @file ramfunc.h
+ * @author Shiki
+ * @brief Run selected hot functions from SRAM instead of flash.
+ *        At 72MHz the flash needs 2 wait states (FLASH_LATENCY_2). The prefetch buffer hides
+ *        most of them on straight-line code, but taken branches in tight loops still stall.
+ *        SRAM has no wait states, but instruction fetches then share the S-bus with data
+ *        accesses. Which one is faster depends on the loop, so measure every candidate with
+ *        the placement benchmark (BLE command 0x05 0xFE) before moving it to RAM.
+ *
+ *        Linker placement: functions marked RAMFUNC go to section ".RamFunc".
+ *        - GCC (STM32CubeIDE): the generated STM32F103ZETX_FLASH.ld already keeps *(.RamFunc)
+ *          inside .data, so the startup code copies it to SRAM with the initialised data.
+ *        - MDK: the default layout from the target dialog leaves ".RamFunc" in flash. Use
+ *          MDK-ARM/BLE_Bracelet.sct, which matches the default layout (512KB flash at
+ *          0x08000000, 64KB SRAM at 0x20000000) plus "*(.RamFunc)" in RW_IRAM1:
+ *          Options for Target -> Linker, untick "Use Memory Layout from Target Dialog" and set
+ *          Scatter File to BLE_Bracelet.sct. Regenerating the project with CubeMX may reset
+ *          this option, so check it again afterwards.
+ *        The placement benchmark checks RAMFUNC_IN_SRAM() and refuses to run when the copies
+ *        are still in flash, so enable the placement flags below only with one of these layouts.
+ *
+ *        Declarations of the RAM copies carry RAMFUNC_DECL: long_call only changes how the
+ *        caller branches, so it has to be visible where the call is compiled.
+ *
+ *        This header has no HAL dependency, the algorithm files still build on the host.
+ * @version 0.1
+ * @date 2025-10-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __RAMFUNC_H
+#define __RAMFUNC_H
+
+#include <stdint.h>
+
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION) && defined(__arm__)
+// RAM 与 flash 相距超过 BL 的 ±16MB 跳转范围，GCC 不插入跳板，调用者需按 long_call 生成代码
+#define RAMFUNC __attribute__((section(".RamFunc"), long_call, noinline))
+#define RAMFUNC_DECL __attribute__((long_call))
+#elif defined(__arm__) || defined(__ARMCC_VERSION)
+// armlink 自动插入长跳转跳板
+#define RAMFUNC __attribute__((section(".RamFunc"), noinline))
+#define RAMFUNC_DECL
+#else
+#define RAMFUNC  // 主机编译时无意义
+#define RAMFUNC_DECL
+#endif
+
+// 函数地址是否位于 SRAM（0x20000000 区域），链接脚本未放置 .RamFunc 时为 false
+#define RAMFUNC_IN_SRAM(fn) (((uint32_t)(uintptr_t)(fn) & 0xE0000000u) == 0x20000000u)
+
+// 函数体只写一次，分别实例化为 flash / RAM 两个版本
+#define RAMFUNC_INLINE static inline __attribute__((always_inline))
+
+// 1: 同时编译所有候选函数的 RAM 版本，供放置基准测试对比；0: 只保留下方选中放到 RAM 的函数
+// 测量时在工程中定义为 1，RAM 版本会一直占用 SRAM
+#ifndef RAMFUNC_BENCHMARK
+#define RAMFUNC_BENCHMARK 0
+#endif
+
+// 各热点函数的放置选择（1: SRAM，0: flash），依据基准测试结果调整
+#ifndef PPG_VALLEY_FILTER_IN_RAM
+#define PPG_VALLEY_FILTER_IN_RAM 0
+#endif
+#ifndef ACF_LAG_MEAN_IN_RAM
+#define ACF_LAG_MEAN_IN_RAM 0
+#endif
+#ifndef MAXIM_SORT_INDICES_IN_RAM
+#define MAXIM_SORT_INDICES_IN_RAM 0
+#endif
+
+#endif /* __RAMFUNC_H */
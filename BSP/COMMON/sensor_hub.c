@@ -0,0 +1,100 @@
+#include "sensor_hub.h"
+
+#include "mpu6050.h"
+
+// 从总线取回一个或多个通道并发布，失败时返回 false
+typedef bool (*SensorFetch_t)(uint32_t now);
+
+typedef struct {
+    SensorSample_t sample;
+    bool valid;
+} SensorSlot_t;
+
+static bool SensorHub_FetchImu(uint32_t now);
+
+// 各通道的按需读取方式，NULL 表示只由采集路径发布
+static const SensorFetch_t sensor_fetch[SENSOR_CH_COUNT] = {
+    SensorHub_FetchImu,  // SENSOR_CH_ACCEL
+    SensorHub_FetchImu,  // SENSOR_CH_GYRO
+    SensorHub_FetchImu,  // SENSOR_CH_IMU_TEMP
+    NULL,                // SENSOR_CH_PPG_TEMP
+};
+
+static SensorSlot_t sensor_slots[SENSOR_CH_COUNT];
+
+// 一次突发读取数据寄存器，同时刷新加速度、角速度和温度
+static bool SensorHub_FetchImu(uint32_t now) {
+    MPU6050_Frame_t frame;
+    int16_t temp;
+
+    if (MPU6050_Read_All(&frame, &temp) != HAL_OK) {
+        return false;  // 例如 DATA_RDY 方式下总线正被 DMA 占用
+    }
+    MPU6050_ToReference(&frame, &frame);  // 与计步发布的数据比例一致
+    SensorHub_Publish(SENSOR_CH_ACCEL, &frame.ax, now);
+    SensorHub_Publish(SENSOR_CH_GYRO, &frame.gx, now);
+    SensorHub_Publish(SENSOR_CH_IMU_TEMP, &temp, now);
+    return true;
+}
+
+/**
+ * @brief 发布一个通道的最新样本，可在中断中调用
+ *
+ * @param ch 通道
+ * @param v 原始值，单值通道只读取 v[0]，三轴通道读取 v[0..2]
+ * @param tick 采集时刻
+ */
+void SensorHub_Publish(SensorChannel_t ch, const int16_t *v, uint32_t tick) {
+    SensorSlot_t *slot = &sensor_slots[ch];
+    uint32_t primask = __get_PRIMASK();
+    bool triple = (ch == SENSOR_CH_ACCEL || ch == SENSOR_CH_GYRO);
+
+    // 读者在任务中拷贝整个样本，关中断保证不会读到半新半旧的三轴数据
+    __disable_irq();
+    slot->sample.v[0] = v[0];
+    slot->sample.v[1] = triple ? v[1] : 0;
+    slot->sample.v[2] = triple ? v[2] : 0;
+    slot->sample.tick = tick;
+    slot->valid = true;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 读取缓存中的最新样本，不访问总线
+ *
+ * @return false 该通道尚未发布过样本
+ */
+bool SensorHub_Peek(SensorChannel_t ch, SensorSample_t *sample) {
+    uint32_t primask = __get_PRIMASK();
+    bool valid;
+
+    __disable_irq();
+    valid = sensor_slots[ch].valid;
+    *sample = sensor_slots[ch].sample;
+    __set_PRIMASK(primask);
+    return valid;
+}
+
+/**
+ * @brief 读取一个通道，缓存不超过 max_age_ms 时直接返回，否则按需从总线读取
+ *        只能在任务中调用（总线读取是阻塞的）
+ *
+ * @param ch 通道
+ * @param max_age_ms 可接受的最大样本年龄
+ * @param sample 输出样本，tick 为实际采集时刻
+ * @return false 没有满足年龄要求的样本（只由采集路径发布的通道已过期，或总线读取失败）
+ */
+bool SensorHub_Read(SensorChannel_t ch, uint32_t max_age_ms, SensorSample_t *sample) {
+    uint32_t now = HAL_GetTick();
+
+    if (ch >= SENSOR_CH_COUNT) {
+        return false;
+    }
+    if (SensorHub_Peek(ch, sample) && now - sample->tick <= max_age_ms) {
+        return true;
+    }
+    if (sensor_fetch[ch] == NULL || !sensor_fetch[ch](now)) {
+        return false;
+    }
+    return SensorHub_Peek(ch, sample);
+}
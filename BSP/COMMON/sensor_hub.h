@@ -0,0 +1,43 @@
+/**
+ * @file sensor_hub.h
+ * @author Shiki
+ * @brief Latest timestamped sample of every sensor channel, served from cache.
+ *        Streamed channels are published by their acquisition path (IMU frames by the step
+ *        counter, die temperature by the MAX30102 task) and never touch the bus on read.
+ *        On-demand channels are fetched over I2C only when the cached sample is older than
+ *        the reader's max age, and one fetch refreshes every channel it returns.
+ *        Scope: the hub is only this cache and the on-demand fetch. It does not own the
+ *        acquisition schedules. The IMU stream rate is set by the step counter (TIM6 poll or
+ *        DATA_RDY, see step_count.h and StepCount_SetImuConfig), and the die temperature period
+ *        by MAX30102_TEMP_PERIOD_MS. Change sampling through those modules, not here.
+ * @version 0.1
+ * @date 2025-10-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __SENSOR_HUB_H
+#define __SENSOR_HUB_H
+
+#include <stdbool.h>
+
+#include "main.h"
+
+typedef enum {
+    SENSOR_CH_ACCEL = 0,  // MPU6050 加速度 x/y/z（参考量程原始值），计步采集时随每批数据发布
+    SENSOR_CH_GYRO,       // MPU6050 角速度 x/y/z（参考量程原始值），同上
+    SENSOR_CH_IMU_TEMP,   // MPU6050 温度原始值 v[0]，按需读取
+    SENSOR_CH_PPG_TEMP,   // MAX30102 芯片温度 v[0] (1/16 degC)，测量期间每秒发布，不可按需读取
+    SENSOR_CH_COUNT
+} SensorChannel_t;
+
+typedef struct {
+    int16_t v[3];   // 原始值，单值通道只用 v[0]
+    uint32_t tick;  // 采集时刻 (HAL_GetTick)
+} SensorSample_t;
+
+void SensorHub_Publish(SensorChannel_t ch, const int16_t *v, uint32_t tick);
+bool SensorHub_Read(SensorChannel_t ch, uint32_t max_age_ms, SensorSample_t *sample);
+bool SensorHub_Peek(SensorChannel_t ch, SensorSample_t *sample);
+
+#endif
@@ -159,6 +159,25 @@ void TaskScheduler_DeleteTask(const char* taskName)
     }
 }
 
+/**
+ * @brief 修改指定任务的执行周期，下一次执行按新周期计算
+ * @param taskName: 任务名称
+ * @param period: 新的执行周期(ms)
+ * @retval HAL_StatusTypeDef
+ */
+HAL_StatusTypeDef TaskScheduler_SetPeriod(const char* taskName, uint32_t period)
+{
+    if (taskName == NULL) return HAL_ERROR;
+
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (strcmp(task_table[i].taskName, taskName) == 0) {
+            task_table[i].period = period;
+            return HAL_OK;
+        }
+    }
+    return HAL_ERROR;
+}
+
 /**
  * @brief 获取系统滴答
  * @retval 系统滴答值
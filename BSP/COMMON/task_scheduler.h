@@ -63,6 +63,7 @@ void TaskScheduler_Run(void);   // 该任务必须在主循环中调用!!!
 void TaskScheduler_SuspendTask(const char* taskName);
 void TaskScheduler_ResumeTask(const char* taskName);
 void TaskScheduler_DeleteTask(const char* taskName);
+HAL_StatusTypeDef TaskScheduler_SetPeriod(const char* taskName, uint32_t period);
 uint32_t TaskScheduler_GetSystemTick(void);
 uint8_t TaskScheduler_GetTaskCount(void);
 void TaskScheduler_PrintTaskInfo(void);
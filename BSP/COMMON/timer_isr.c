@@ -1,10 +1,38 @@
+#include "max30102_user.h"
+#include "mpu6050.h"
 #include "step_count.h"
 
 // 定时器中断回调函数
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
     if (htim->Instance == TIM6) {
-        // 50ms执行一次TIM6中断
+        // 10ms执行一次TIM6中断（仅轮询采集方式）
         Timer_Handler_StepCount();
     }
-}
\ No newline at end of file
+}
+
+// 外部中断回调函数
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin == MAX30102_INT_Pin) {
+        MAX30102_IntHandler();
+    } else if (GPIO_Pin == MPU6050_INT_Pin) {
+        MPU6050_IntHandler();
+    }
+}
+
+// I2C DMA 读取完成回调函数
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c->Instance == I2C2) {
+        MPU6050_DmaCpltHandler();
+    }
+}
+
+// I2C 错误回调函数
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c->Instance == I2C2) {
+        MPU6050_DmaErrorHandler();
+    }
+}
@@ -4,10 +4,16 @@
 
 #include "app_tasks.h"
 #include "atgm336h.h"
+#include "command.h"
+#include "cycle_counter.h"
+#include "fall_alert.h"
+#include "imu_calib.h"
 #include "max30102_user.h"
 #include "mpu6050.h"
 #include "oled_hardware_spi.h"
-#include "tim.h"
+#include "step_count.h"
+#include "step_log.h"
+#include "uart_tx.h"
 #include "uart_user.h"
 #include "usart.h"
 
@@ -16,9 +22,12 @@
  *
  */
 void User_Init(void) {
-    // BLE Uart 空闲中断接收使能并关闭 DMA 过半中断
-    HAL_UARTEx_ReceiveToIdle_DMA(&huart2, g_uart_command_buffer, UART_USER_BUFFER_SIZE);
-    __HAL_DMA_DISABLE_IT(&hdma_usart2_rx, DMA_IT_HT);
+    // DWT 周期计数器，用于算法耗时统计
+    CycleCounter_Init();
+    // printf 与应答经由 DMA 发送队列输出
+    UartTx_Init(&huart2);
+    // BLE Uart 以循环 DMA 接收到指令缓冲区，由解析任务直接读取
+    Command_StartReceive(&huart2);
     // OLED 初始化
     OLED_Init();
     OLED_Clear();
@@ -30,13 +39,16 @@ void User_Init(void) {
         while (true) {
         }
     }
+    // 恢复保存在备份寄存器中的 IMU 偏移
+    ImuCalib_Init();
+    // 跌倒检测按当前采样配置初始化
+    FallAlert_Init();
     // MAX30102 初始化
     MAX30102_System_Init();
-    // 启动计步定时器6，50ms中断一次
-    // 清除定时器初始化过程中的更新中断标志，避免定时器一启动就中断
-    __HAL_TIM_CLEAR_IT(&htim6, TIM_IT_UPDATE);
-    // 使能定时器6更新中断并启动定时器
-    HAL_TIM_Base_Start_IT(&htim6);
+    // 恢复当天步数，关机期间跨日时切换到新的一天
+    StepLog_Init();
+    // 启动计步：轮询方式下由定时器6每 10ms 读取一次，DATA_RDY 方式下由 MPU6050 INT 驱动
+    StepCount_Start(MPU6050_ACQ_MODE_DEFAULT);
     // 初始化应用任务
     AppTasks_Init();
 }
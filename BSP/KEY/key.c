@@ -3,7 +3,7 @@
 #include <stdio.h>
 
 #include "oled_user.h"
-#include "step_count.h"
+#include "step_log.h"
 
 // GPIO端口和引脚宏定义兼容
 #if 0
@@ -235,10 +235,14 @@ void Task_KeyProc(void) {
     KeyValue_t key_val = Key_GetDebounced();
     /* 只有在按键值变化且不为KEY_NONE时才处理 */
     if (key_val != KEY_NONE && key_val != key_val_old) {
-        if (key_val == KEY_0) {
+        bool was_on = OLED_IsOn();
+        OLED_Wake();  // 点亮屏幕或延长亮屏时间
+        if (!was_on) {
+            // 熄屏时按键只用于点亮屏幕
+        } else if (key_val == KEY_0) {
             // printf("KEY_0 Pressed!\n");
             if (g_curr_main_interface == OLED_STEP_GPS) {
-                g_step = 0;  // 重置步数计数
+                StepLog_ClearToday();  // 清零当天步数
             }
         } else if (key_val == KEY_1) {
             // printf("KEY_1 Pressed!\n");
@@ -65,7 +65,9 @@
  */
 #include "algorithm.h"
 
-const uint16_t auw_hamm[31] = {41, 276, 512, 276, 41};  // Hamm=  long16(512* hamming(5)');
+#include "ppg_dsp.h"
+#include "ramfunc.h"
+
 // uch_spo2_table is computed as  -45.060*ratioAverage* ratioAverage + 30.354 *ratioAverage + 94.845
 // ;
 const uint8_t uch_spo2_table[184] = {
@@ -82,6 +84,8 @@ const uint8_t uch_spo2_table[184] = {
 static int32_t an_dx[BUFFER_SIZE - MA4_SIZE];  // delta
 static int32_t an_x[BUFFER_SIZE];              // ir
 static int32_t an_y[BUFFER_SIZE];              // red
+static int32_t an_beat_locs[15];               // 最近一次计算的谷值位置（升序）
+static int32_t n_beat_count;
 
 void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length,
                                             uint32_t *pun_red_buffer, int32_t *pn_spo2,
@@ -106,10 +110,10 @@ void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_i
  * \retval       None
  */
 {
-    uint32_t un_ir_mean, un_only_once;
+    uint32_t un_only_once;
     int32_t k, n_i_ratio_count;
-    int32_t i, s, m, n_exact_ir_valley_locs_count, n_middle_idx;
-    int32_t n_th1, n_npks, n_c_min;
+    int32_t i, m, n_exact_ir_valley_locs_count, n_middle_idx;
+    int32_t n_th1, n_npks, n_c_min, n_dx_size;
     int32_t an_ir_valley_locs[15];
     int32_t an_exact_ir_valley_locs[15];
     int32_t an_dx_peak_locs[15];
@@ -121,48 +125,22 @@ void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_i
     int32_t n_y_dc_max_idx, n_x_dc_max_idx;
     int32_t an_ratio[5], n_ratio_average;
     int32_t n_nume, n_denom;
-    // remove DC of ir signal
-    un_ir_mean = 0;
-    for (k = 0; k < n_ir_buffer_length; k++)
-        un_ir_mean += pun_ir_buffer[k];
-    un_ir_mean = un_ir_mean / n_ir_buffer_length;
-    for (k = 0; k < n_ir_buffer_length; k++)
-        an_x[k] = pun_ir_buffer[k] - un_ir_mean;
-
-    // 4 pt Moving Average
-    for (k = 0; k < BUFFER_SIZE - MA4_SIZE; k++) {
-        n_denom = (an_x[k] + an_x[k + 1] + an_x[k + 2] + an_x[k + 3]);
-        an_x[k] = n_denom / (int32_t)4;
-    }
-
-    // get difference of smoothed IR signal
 
-    for (k = 0; k < BUFFER_SIZE - MA4_SIZE - 1; k++)
-        an_dx[k] = (an_x[k + 1] - an_x[k]);
-
-    // 2-pt Moving Average to an_dx
-    for (k = 0; k < BUFFER_SIZE - MA4_SIZE - 2; k++) {
-        an_dx[k] = (an_dx[k] + an_dx[k + 1]) / 2;
-    }
-
-    // hamming window
+    n_beat_count = 0;
+    // 4 pt MA -> difference -> 2 pt MA -> hamming window, fused into one pass (see ppg_dsp.h)
+    // the chain has no DC gain so the IR mean does not need to be removed first
     // flip wave form so that we can detect valley with peak detector
-    for (i = 0; i < BUFFER_SIZE - HAMMING_SIZE - MA4_SIZE - 2; i++) {
-        s = 0;
-        for (k = i; k < i + HAMMING_SIZE; k++) {
-            s -= an_dx[k] * auw_hamm[k - i];
-        }
-        an_dx[i] = s / (int32_t)1146;  // divide by sum of auw_hamm
-    }
+    n_dx_size = n_ir_buffer_length - PPG_VALLEY_FILTER_DELAY;
+    ppg_valley_filter((const int32_t *)pun_ir_buffer, an_dx, n_ir_buffer_length);
 
     n_th1 = 0;  // threshold calculation
-    for (k = 0; k < BUFFER_SIZE - HAMMING_SIZE; k++) {
+    for (k = 0; k < n_dx_size; k++) {
         n_th1 += ((an_dx[k] > 0) ? an_dx[k] : ((int32_t)0 - an_dx[k]));
     }
-    n_th1 = n_th1 / (BUFFER_SIZE - HAMMING_SIZE);
+    n_th1 = n_th1 / n_dx_size;
     // peak location is acutally index for sharpest location of raw signal since we flipped the
     // signal
-    maxim_find_peaks(an_dx_peak_locs, &n_npks, an_dx, BUFFER_SIZE - HAMMING_SIZE, n_th1, 8,
+    maxim_find_peaks(an_dx_peak_locs, &n_npks, an_dx, n_dx_size, n_th1, 8,
                      5);  // peak_height, peak_distance, max_num_peaks
 
     n_peak_interval_sum = 0;
@@ -202,8 +180,10 @@ void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_i
                     n_c_min = an_x[i];
                     an_exact_ir_valley_locs[k] = i;
                 }
-            if (un_only_once == 0)
+            if (un_only_once == 0) {
                 n_exact_ir_valley_locs_count++;
+                an_beat_locs[n_beat_count++] = an_exact_ir_valley_locs[k];
+            }
         }
     }
     if (n_exact_ir_valley_locs_count < 2) {
@@ -211,10 +191,10 @@ void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_i
         *pch_spo2_valid = 0;
         return;
     }
-    // 4 pt MA
+    // 4 pt MA (raw samples are non-negative, shift is exact)
     for (k = 0; k < BUFFER_SIZE - MA4_SIZE; k++) {
-        an_x[k] = (an_x[k] + an_x[k + 1] + an_x[k + 2] + an_x[k + 3]) / (int32_t)4;
-        an_y[k] = (an_y[k] + an_y[k + 1] + an_y[k + 2] + an_y[k + 3]) / (int32_t)4;
+        an_x[k] = (an_x[k] + an_x[k + 1] + an_x[k + 2] + an_x[k + 3]) >> 2;
+        an_y[k] = (an_y[k] + an_y[k + 1] + an_y[k + 2] + an_y[k + 3]) >> 2;
     }
 
     // using an_exact_ir_valley_locs , find ir-red DC andir-red AC for SPO2 calibration ratio
@@ -291,6 +271,23 @@ void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_i
     }
 }
 
+int32_t maxim_get_beat_locs(int32_t *pn_locs, int32_t n_max)
+/**
+ * \brief        Valley (beat) locations found by the last maxim_heart_rate_and_oxygen_saturation()
+ *
+ * \param[out]   *pn_locs                 - Sample indices within the analysed window, ascending
+ * \param[in]    n_max                    - Capacity of pn_locs
+ *
+ * \retval       Number of locations written
+ */
+{
+    int32_t k, n_count = min(n_beat_count, n_max);
+
+    for (k = 0; k < n_count; k++)
+        pn_locs[k] = an_beat_locs[k];
+    return n_count;
+}
+
 void maxim_find_peaks(int32_t *pn_locs, int32_t *pn_npks, int32_t *pn_x, int32_t n_size,
                       int32_t n_min_height, int32_t n_min_distance, int32_t n_max_num)
 /**
@@ -383,7 +380,8 @@ void maxim_sort_ascend(int32_t *pn_x, int32_t n_size)
     }
 }
 
-void maxim_sort_indices_descend(int32_t *pn_x, int32_t *pn_indx, int32_t n_size)
+RAMFUNC_INLINE void maxim_sort_indices_descend_body(int32_t *pn_x, int32_t *pn_indx,
+                                                    int32_t n_size)
 /**
  * \brief        Sort indices
  * \par          Details
@@ -399,4 +397,30 @@ void maxim_sort_indices_descend(int32_t *pn_x, int32_t *pn_indx, int32_t n_size)
             pn_indx[j] = pn_indx[j - 1];
         pn_indx[j] = n_temp;
     }
-}
\ No newline at end of file
+}
+
+void maxim_sort_indices_descend_flash(int32_t *pn_x, int32_t *pn_indx, int32_t n_size)
+{
+    maxim_sort_indices_descend_body(pn_x, pn_indx, n_size);
+}
+
+#if MAXIM_SORT_INDICES_IN_RAM || RAMFUNC_BENCHMARK
+RAMFUNC void maxim_sort_indices_descend_ram(int32_t *pn_x, int32_t *pn_indx, int32_t n_size)
+{
+    maxim_sort_indices_descend_body(pn_x, pn_indx, n_size);
+}
+#endif
+
+void maxim_sort_indices_descend(int32_t *pn_x, int32_t *pn_indx, int32_t n_size)
+/**
+ * \brief        Sort indices, placement selected in ramfunc.h
+ *
+ * \retval       None
+ */
+{
+#if MAXIM_SORT_INDICES_IN_RAM
+    maxim_sort_indices_descend_ram(pn_x, pn_indx, n_size);
+#else
+    maxim_sort_indices_descend_flash(pn_x, pn_indx, n_size);
+#endif
+}
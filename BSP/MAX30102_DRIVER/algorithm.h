@@ -72,7 +72,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "main.h"
+#include "ramfunc.h"
 
 /// @note Using standard stdbool.h instead of custom defines
 #define FS 100
@@ -102,10 +102,13 @@
 // static  int32_t an_x[ BUFFER_SIZE]; //ir
 // static  int32_t an_y[ BUFFER_SIZE]; //red
 
+extern const uint8_t uch_spo2_table[184];  // shared with the autocorrelation engine
+
 void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length,
                                             uint32_t *pun_red_buffer, int32_t *pn_spo2,
                                             int8_t *pch_spo2_valid, int32_t *pn_heart_rate,
                                             int8_t *pch_hr_valid);
+int32_t maxim_get_beat_locs(int32_t *pn_locs, int32_t n_max);
 void maxim_find_peaks(int32_t *pn_locs, int32_t *pn_npks, int32_t *pn_x, int32_t n_size,
                       int32_t n_min_height, int32_t n_min_distance, int32_t n_max_num);
 void maxim_peaks_above_min_height(int32_t *pn_locs, int32_t *pn_npks, int32_t *pn_x, int32_t n_size,
@@ -114,5 +117,8 @@ void maxim_remove_close_peaks(int32_t *pn_locs, int32_t *pn_npks, int32_t *pn_x,
                               int32_t n_min_distance);
 void maxim_sort_ascend(int32_t *pn_x, int32_t n_size);
 void maxim_sort_indices_descend(int32_t *pn_x, int32_t *pn_indx, int32_t n_size);
+void maxim_sort_indices_descend_flash(int32_t *pn_x, int32_t *pn_indx, int32_t n_size);
+RAMFUNC_DECL void maxim_sort_indices_descend_ram(int32_t *pn_x, int32_t *pn_indx,
+                                                 int32_t n_size);
 
 #endif /* ALGORITHM_H_ */
\ No newline at end of file
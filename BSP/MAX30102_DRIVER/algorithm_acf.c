@@ -0,0 +1,290 @@
+/**
+ * @file    algorithm_acf.c
+ * @brief   Autocorrelation based heart rate and SpO2 estimator
+ * @version V1.0
+ * @date    2025-10-20
+ * @note    The IR window is decimated by 2, detrended and scaled to 12 bits, then the
+ *          normalized autocorrelation is searched from the shortest period (200 bpm) upwards.
+ *          The first local maximum above ACF_MIN_CORRELATION_PCT of r(0) is the beat period,
+ *          so the search exits early on fast heart rates and never evaluates harmonics.
+ *          SpO2 reuses uch_spo2_table[] with the same ratio scaling as the Maxim engine,
+ *          measuring AC/DC per detected period instead of between valley locations.
+ *
+ *          Naming follows the Maxim conventions used in algorithm.c (n_ / an_ / pun_ ...).
+ */
+#include "algorithm_acf.h"
+
+#include "algorithm.h"
+#include "ramfunc.h"
+
+#define ACF_MIN_CORRELATION_PCT 50  // 周期峰值的最小归一化相关度 (r(lag) / r(0), %)
+#define ACF_MAX_RATIOS 5            // SpO2 最多取 5 个周期的比值求中值
+
+static int32_t an_x[ACF_MAX_INPUT / ACF_DECIMATION];  // 抽取并去趋势后的 IR 信号
+static int32_t an_beat_locs[ACF_MAX_BEATS];           // 最近一次计算的谷值位置（升序）
+static int32_t n_beat_count;
+
+RAMFUNC_INLINE int32_t acf_lag_mean_body(const int32_t *pn_x, int32_t n_size, int32_t n_lag)
+/**
+ * \brief        Autocorrelation at one lag
+ * \par          Details
+ *               Mean of x[k]*x[k+lag] over the overlapping part, so lags with fewer terms
+ *               are not penalised. Inputs are limited to ACF_SAMPLE_BITS, the int32 sum
+ *               cannot overflow for ACF_MAX_INPUT / ACF_DECIMATION terms.
+ *
+ * \retval       Mean product at the given lag
+ */
+{
+    const int32_t *pn_a = pn_x;
+    const int32_t *pn_b = pn_x + n_lag;
+    int32_t n_terms = n_size - n_lag;
+    int32_t n_sum = 0;
+    int32_t k;
+
+    for (k = 0; k + 4 <= n_terms; k += 4) {
+        n_sum += pn_a[k] * pn_b[k] + pn_a[k + 1] * pn_b[k + 1] + pn_a[k + 2] * pn_b[k + 2] +
+                 pn_a[k + 3] * pn_b[k + 3];
+    }
+    for (; k < n_terms; k++)
+        n_sum += pn_a[k] * pn_b[k];
+
+    return n_sum / n_terms;
+}
+
+int32_t acf_lag_mean_flash(const int32_t *pn_x, int32_t n_size, int32_t n_lag)
+{
+    return acf_lag_mean_body(pn_x, n_size, n_lag);
+}
+
+#if ACF_LAG_MEAN_IN_RAM || RAMFUNC_BENCHMARK
+RAMFUNC int32_t acf_lag_mean_ram(const int32_t *pn_x, int32_t n_size, int32_t n_lag)
+{
+    return acf_lag_mean_body(pn_x, n_size, n_lag);
+}
+#endif
+
+// 放置选择见 ramfunc.h
+static inline int32_t acf_lag_mean(const int32_t *pn_x, int32_t n_size, int32_t n_lag)
+{
+#if ACF_LAG_MEAN_IN_RAM
+    return acf_lag_mean_ram(pn_x, n_size, n_lag);
+#else
+    return acf_lag_mean_flash(pn_x, n_size, n_lag);
+#endif
+}
+
+static void acf_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length,
+                                  uint32_t *pun_red_buffer, int32_t n_period, int32_t *pn_spo2,
+                                  int8_t *pch_spo2_valid)
+/**
+ * \brief        SpO2 from per-period AC/DC
+ * \par          Details
+ *               Walks the window backwards one beat period at a time (newest beats first)
+ *               and takes max-min of a 4 point moving sum as AC and the max as DC, like the
+ *               Maxim engine does between two valleys. The minimum of each period is recorded
+ *               as the beat location.
+ *
+ * \retval       None
+ */
+{
+    int32_t an_ratio[ACF_MAX_RATIOS];
+    int32_t n_ratio_count = 0;
+    int32_t n_seg_end, i, n_middle_idx, n_ratio_average;
+    int32_t n_x_sum, n_y_sum, n_x_max, n_x_min, n_y_max, n_y_min, n_x_min_idx;
+    int64_t n_nume, n_denom;
+
+    // 4 点滑动和需要 i + 3 < length
+    n_seg_end = n_ir_buffer_length - (MA4_SIZE - 1);
+    while (n_seg_end - n_period >= 0 && n_beat_count < ACF_MAX_BEATS) {
+        i = n_seg_end - n_period;
+        n_x_sum = pun_ir_buffer[i] + pun_ir_buffer[i + 1] + pun_ir_buffer[i + 2];
+        n_y_sum = pun_red_buffer[i] + pun_red_buffer[i + 1] + pun_red_buffer[i + 2];
+        n_x_max = n_y_max = 0;
+        n_x_min = n_y_min = 0x7FFFFFFF;
+        n_x_min_idx = i;
+        for (; i < n_seg_end; i++) {
+            n_x_sum += pun_ir_buffer[i + 3];
+            n_y_sum += pun_red_buffer[i + 3];
+            if (n_x_sum > n_x_max)
+                n_x_max = n_x_sum;
+            if (n_x_sum < n_x_min) {
+                n_x_min = n_x_sum;
+                n_x_min_idx = i;
+            }
+            if (n_y_sum > n_y_max)
+                n_y_max = n_y_sum;
+            if (n_y_sum < n_y_min)
+                n_y_min = n_y_sum;
+            n_x_sum -= pun_ir_buffer[i];
+            n_y_sum -= pun_red_buffer[i];
+        }
+        n_seg_end -= n_period;
+        an_beat_locs[n_beat_count++] = n_x_min_idx + MA4_SIZE / 2;  // 4 点和的中心
+        if (n_ratio_count >= ACF_MAX_RATIOS)
+            continue;
+
+        // formular is ( n_y_ac *n_x_dc_max) / ( n_x_ac *n_y_dc_max)，与 Maxim 引擎保持同一缩放
+        n_nume = (int64_t)(n_y_max - n_y_min) * n_x_max;
+        n_denom = (int64_t)(n_x_max - n_x_min) * n_y_max;
+        if (n_denom > 0 && n_nume > 0)
+            an_ratio[n_ratio_count++] = (int32_t)((n_nume * 20) / n_denom);
+    }
+
+    // 由新到旧记录，翻转为升序
+    for (i = 0; i < n_beat_count / 2; i++) {
+        n_x_sum = an_beat_locs[i];
+        an_beat_locs[i] = an_beat_locs[n_beat_count - 1 - i];
+        an_beat_locs[n_beat_count - 1 - i] = n_x_sum;
+    }
+
+    if (n_ratio_count == 0) {
+        *pn_spo2 = -999;
+        *pch_spo2_valid = 0;
+        return;
+    }
+
+    maxim_sort_ascend(an_ratio, n_ratio_count);
+    n_middle_idx = n_ratio_count / 2;
+    if (n_middle_idx > 1)
+        n_ratio_average = (an_ratio[n_middle_idx - 1] + an_ratio[n_middle_idx]) / 2;  // use median
+    else
+        n_ratio_average = an_ratio[n_middle_idx];
+
+    if (n_ratio_average > 2 && n_ratio_average < 184) {
+        *pn_spo2 = uch_spo2_table[n_ratio_average];
+        *pch_spo2_valid = 1;
+    } else {
+        *pn_spo2 = -999;  // do not use SPO2 since signal ratio is out of range
+        *pch_spo2_valid = 0;
+    }
+}
+
+void acf_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length,
+                                          uint32_t *pun_red_buffer, int32_t *pn_spo2,
+                                          int8_t *pch_spo2_valid, int32_t *pn_heart_rate,
+                                          int8_t *pch_hr_valid)
+/**
+ * \brief        Calculate the heart rate and SpO2 level by autocorrelation
+ *
+ * \param[in]    *pun_ir_buffer           - IR sensor data buffer
+ * \param[in]    n_ir_buffer_length      - IR sensor data buffer length
+ * \param[in]    *pun_red_buffer          - Red sensor data buffer
+ * \param[out]    *pn_spo2                - Calculated SpO2 value
+ * \param[out]    *pch_spo2_valid         - 1 if the calculated SpO2 value is valid
+ * \param[out]    *pn_heart_rate          - Calculated heart rate value
+ * \param[out]    *pch_hr_valid           - 1 if the calculated heart rate value is valid
+ *
+ * \retval       None
+ */
+{
+    int32_t k, n_len, n_quarter, n_head, n_tail, n_span, n_max_abs, n_shift;
+    int32_t n_r0, n_prev, n_curr, n_next, n_lag, n_peak_lag, n_denom, n_period_q8;
+
+    *pn_heart_rate = -999;
+    *pch_hr_valid = 0;
+    *pn_spo2 = -999;
+    *pch_spo2_valid = 0;
+    n_beat_count = 0;
+
+    if (n_ir_buffer_length > ACF_MAX_INPUT)
+        n_ir_buffer_length = ACF_MAX_INPUT;
+    n_len = n_ir_buffer_length / ACF_DECIMATION;
+    if (n_len < 2 * ACF_LAG_MAX)  // 至少需要两个最长周期
+        return;
+
+    // 2 点求和抽取到 50Hz（同时起到低通作用）
+    for (k = 0; k < n_len; k++)
+        an_x[k] = (int32_t)(pun_ir_buffer[2 * k] + pun_ir_buffer[2 * k + 1]);
+
+    // 去趋势：用首尾各 1/4 窗口的均值连线作为基线，比单纯去均值更能抑制基线漂移
+    n_quarter = n_len / 4;
+    n_head = 0;
+    n_tail = 0;
+    for (k = 0; k < n_quarter; k++) {
+        n_head += an_x[k];
+        n_tail += an_x[n_len - n_quarter + k];
+    }
+    n_head /= n_quarter;
+    n_tail /= n_quarter;
+    n_span = n_len - n_quarter;  // 两段中心点之间的距离
+    n_max_abs = 0;
+    for (k = 0; k < n_len; k++) {
+        an_x[k] -= n_head + (n_tail - n_head) * (k - (n_quarter - 1) / 2) / n_span;
+        if (an_x[k] > n_max_abs)
+            n_max_abs = an_x[k];
+        else if (-an_x[k] > n_max_abs)
+            n_max_abs = -an_x[k];
+    }
+    if (n_max_abs == 0)
+        return;
+
+    // 缩放到 ACF_SAMPLE_BITS 以内，自相关累加全部使用 int32
+    n_shift = 0;
+    while ((n_max_abs >> n_shift) >= (1 << ACF_SAMPLE_BITS))
+        n_shift++;
+    if (n_shift) {
+        for (k = 0; k < n_len; k++)
+            an_x[k] >>= n_shift;
+    }
+
+    n_r0 = acf_lag_mean(an_x, n_len, 0);
+    if (n_r0 <= 0)
+        return;
+
+    // 从最短周期开始搜索第一个足够高的局部极大值，找到即退出
+    n_peak_lag = 0;
+    n_prev = acf_lag_mean(an_x, n_len, ACF_LAG_MIN - 1);
+    n_curr = acf_lag_mean(an_x, n_len, ACF_LAG_MIN);
+    n_next = 0;
+    for (n_lag = ACF_LAG_MIN; n_lag < ACF_LAG_MAX; n_lag++) {
+        n_next = acf_lag_mean(an_x, n_len, n_lag + 1);
+        if (n_curr > n_prev && n_curr >= n_next &&
+            n_curr * 100 > n_r0 * ACF_MIN_CORRELATION_PCT) {
+            n_peak_lag = n_lag;
+            break;
+        }
+        n_prev = n_curr;
+        n_curr = n_next;
+    }
+    if (n_peak_lag == 0)
+        return;
+
+    // 抛物线插值细化周期，Q8 定点（1/256 个抽取样本）
+    n_period_q8 = n_peak_lag << 8;
+    n_denom = n_prev - 2 * n_curr + n_next;
+    if (n_denom < 0) {
+        k = (128 * (n_prev - n_next)) / n_denom;
+        if (k > 128)
+            k = 128;
+        else if (k < -128)
+            k = -128;
+        n_period_q8 += k;
+    }
+
+    *pn_heart_rate = (ACF_FS_DEC * 60 * 256 + n_period_q8 / 2) / n_period_q8;
+    *pch_hr_valid = (*pn_heart_rate >= ACF_HR_MIN && *pn_heart_rate <= ACF_HR_MAX) ? 1 : 0;
+    if (!*pch_hr_valid) {
+        *pn_heart_rate = -999;
+        return;
+    }
+
+    acf_oxygen_saturation(pun_ir_buffer, n_ir_buffer_length, pun_red_buffer,
+                          (n_period_q8 * ACF_DECIMATION + 128) >> 8, pn_spo2, pch_spo2_valid);
+}
+
+int32_t acf_get_beat_locs(int32_t *pn_locs, int32_t n_max)
+/**
+ * \brief        Valley (beat) locations found by the last acf_heart_rate_and_oxygen_saturation()
+ *
+ * \param[out]   *pn_locs                 - Sample indices within the analysed window, ascending
+ * \param[in]    n_max                    - Capacity of pn_locs
+ *
+ * \retval       Number of locations written
+ */
+{
+    int32_t k, n_count = (n_beat_count < n_max) ? n_beat_count : n_max;
+
+    for (k = 0; k < n_count; k++)
+        pn_locs[k] = an_beat_locs[k];
+    return n_count;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file    algorithm_acf.h
+ * @brief   Autocorrelation based heart rate and SpO2 estimator header
+ * @version V1.0
+ * @date    2025-10-20
+ * @note    Alternative engine to maxim_heart_rate_and_oxygen_saturation(), same calling
+ *          convention so both can be selected at runtime through a function pointer.
+ *          Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ */
+#ifndef ALGORITHM_ACF_H_
+#define ALGORITHM_ACF_H_
+
+#include <stdint.h>
+
+#include "ramfunc.h"
+
+#define ACF_FS 100                             // 输入采样率 (Hz)
+#define ACF_DECIMATION 2                       // 抽取因子，自相关在 50Hz 上计算
+#define ACF_FS_DEC (ACF_FS / ACF_DECIMATION)   // 抽取后采样率
+#define ACF_HR_MIN 40                          // 搜索的最低心率 (bpm)
+#define ACF_HR_MAX 200                         // 搜索的最高心率 (bpm)
+#define ACF_LAG_MIN (ACF_FS_DEC * 60 / ACF_HR_MAX)  // 最短周期 (抽取后样本数)
+#define ACF_LAG_MAX (ACF_FS_DEC * 60 / ACF_HR_MIN)  // 最长周期 (抽取后样本数)
+#define ACF_MAX_INPUT 500                      // 支持的最大窗口长度
+#define ACF_SAMPLE_BITS 11                     // 自相关前将信号缩放到 ±2^11 以内，防止累加溢出
+#define ACF_MAX_BEATS (ACF_MAX_INPUT * ACF_HR_MAX / (ACF_FS * 60) + 1)  // 窗口内最多的心跳数
+
+void acf_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length,
+                                          uint32_t *pun_red_buffer, int32_t *pn_spo2,
+                                          int8_t *pch_spo2_valid, int32_t *pn_heart_rate,
+                                          int8_t *pch_hr_valid);
+int32_t acf_get_beat_locs(int32_t *pn_locs, int32_t n_max);
+// 自相关内核的 flash / RAM 两个版本，放置选择见 ramfunc.h
+int32_t acf_lag_mean_flash(const int32_t *pn_x, int32_t n_size, int32_t n_lag);
+RAMFUNC_DECL int32_t acf_lag_mean_ram(const int32_t *pn_x, int32_t n_size, int32_t n_lag);
+
+#endif /* ALGORITHM_ACF_H_ */
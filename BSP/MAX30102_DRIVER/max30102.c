@@ -10,6 +10,19 @@
 
 #include "myiic.h"
 
+static uint8_t die_temp_ready = 0;  // 读状态寄存器时锁存的 DIE_TEMP_RDY
+
+/// @brief Read (and thereby clear) both interrupt status registers so the INT pin is released
+/// @note DIE_TEMP_RDY is cleared by any status read (e.g. before every FIFO burst), so it is
+///       latched here until max30102_Temp_Read() collects the conversion
+static void max30102_ClearIntStatus(void)
+{
+    max30102_Bus_Read(REG_INTR_STATUS_1);
+    if (max30102_Bus_Read(REG_INTR_STATUS_2) & INTR_STATUS_2_DIE_TEMP_RDY) {
+        die_temp_ready = 1;
+    }
+}
+
 /// @brief Write data to MAX30102 register using HAL I2C
 /// @param Register_Address Target register address
 /// @param Word_Data Data byte to write
@@ -84,6 +97,59 @@ void max30102_FIFO_ReadBytes(uint8_t Register_Address, uint8_t *Data)
     // max30102_Bus_Write(REG_FIFO_RD_PTR,fifo_wr_ptr);
 }
 
+/// @brief Get the number of unread samples in the MAX30102 FIFO
+/// @note FIFO rollover is disabled, so a full FIFO has WR_PTR == RD_PTR with a non-zero
+///       overflow counter; that case is reported as MAX30102_FIFO_DEPTH
+/// @param pun_overflow Optional output, samples lost since the last FIFO read (OVF_COUNTER,
+///        saturates at MAX30102_OVF_COUNTER_MAX and clears once a sample is popped)
+/// @return Number of samples ready to be read (0..MAX30102_FIFO_DEPTH)
+uint8_t max30102_FIFO_GetAvailable(uint8_t *pun_overflow)
+{
+    uint8_t wr_ptr = max30102_Bus_Read(REG_FIFO_WR_PTR);
+    uint8_t ovf = max30102_Bus_Read(REG_OVF_COUNTER) & MAX30102_OVF_COUNTER_MAX;
+    uint8_t rd_ptr = max30102_Bus_Read(REG_FIFO_RD_PTR);
+    uint8_t available = (uint8_t)(wr_ptr - rd_ptr) & (MAX30102_FIFO_DEPTH - 1);
+
+    if (available == 0 && ovf != 0) {
+        available = MAX30102_FIFO_DEPTH;
+    }
+    if (pun_overflow) {
+        *pun_overflow = ovf;
+    }
+    return available;
+}
+
+/// @brief Burst read several Red/IR samples from the FIFO in one I2C transaction
+/// @param pun_red Output buffer for 18-bit Red samples
+/// @param pun_ir Output buffer for 18-bit IR samples
+/// @param count Number of samples to read (at most MAX30102_FIFO_DEPTH)
+/// @return Number of samples actually read, 0 on bus error
+uint8_t max30102_FIFO_ReadSamples(uint32_t *pun_red, uint32_t *pun_ir, uint8_t count)
+{
+    uint8_t buffer[MAX30102_FIFO_DEPTH * MAX30102_BYTES_PER_SAMPLE];
+
+    if (count > MAX30102_FIFO_DEPTH) {
+        count = MAX30102_FIFO_DEPTH;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    max30102_ClearIntStatus();
+
+    if (HAL_I2C_Mem_Read(&MAX30102_I2C_HANDLE, max30102_WR_address, REG_FIFO_DATA,
+                         I2C_MEMADD_SIZE_8BIT, buffer, count * MAX30102_BYTES_PER_SAMPLE,
+                         HAL_MAX_DELAY) != HAL_OK) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t *p = &buffer[i * MAX30102_BYTES_PER_SAMPLE];
+        pun_red[i] = ((uint32_t)(p[0] & 0x03) << 16) | ((uint32_t)p[1] << 8) | p[2];
+        pun_ir[i] = ((uint32_t)(p[3] & 0x03) << 16) | ((uint32_t)p[4] << 8) | p[5];
+    }
+    return count;
+}
+
 /// @brief Initialize MAX30102 sensor using HAL library
 void max30102_init(void)
 {
@@ -108,7 +174,7 @@ void max30102_init(void)
     //  max30102_Bus_Write(REG_LED2_PA, 0x47);
 
     max30102_Bus_Write(REG_INTR_ENABLE_1, 0xc0);  // INTR setting
-    max30102_Bus_Write(REG_INTR_ENABLE_2, 0x00);
+    max30102_Bus_Write(REG_INTR_ENABLE_2, INTR_ENABLE_2_DIE_TEMP_RDY);
     max30102_Bus_Write(REG_FIFO_WR_PTR, 0x00);  // FIFO_WR_PTR[4:0]
     max30102_Bus_Write(REG_OVF_COUNTER, 0x00);  // OVF_COUNTER[4:0]
     max30102_Bus_Write(REG_FIFO_RD_PTR, 0x00);  // FIFO_RD_PTR[4:0]
@@ -119,8 +185,8 @@ void max30102_init(void)
     max30102_Bus_Write(
         REG_SPO2_CONFIG,
         0x27);  // SPO2_ADC range = 4096nA, SPO2 sample rate (100 Hz), LED pulseWidth (400uS)
-    max30102_Bus_Write(REG_LED1_PA, 0x24);   // Choose value for ~ 7mA for LED1
-    max30102_Bus_Write(REG_LED2_PA, 0x24);   // Choose value for ~ 7mA for LED2
+    max30102_Bus_Write(REG_LED1_PA, MAX30102_LED_PA_DEFAULT);  // Choose value for ~ 7mA for LED1
+    max30102_Bus_Write(REG_LED2_PA, MAX30102_LED_PA_DEFAULT);  // Choose value for ~ 7mA for LED2
     max30102_Bus_Write(REG_PILOT_PA, 0x7f);  // Choose value for ~ 25mA for Pilot LED
 
     //  // Interrupt Enable 1 Register. Set PPG_RDY_EN (data available in FIFO)
@@ -156,6 +222,79 @@ void max30102_reset(void)
     max30102_Bus_Write(REG_MODE_CONFIG, 0x40);
 }
 
+/// @brief Enter power-save mode (MODE_CONFIG SHDN), LEDs off, registers retained
+void max30102_shutdown(void)
+{
+    uint8_t mode = max30102_Bus_Read(REG_MODE_CONFIG);
+    max30102_Bus_Write(REG_MODE_CONFIG, mode | MODE_CONFIG_SHDN);
+}
+
+/// @brief Leave power-save mode, sampling restarts with the retained configuration
+void max30102_wakeup(void)
+{
+    uint8_t mode = max30102_Bus_Read(REG_MODE_CONFIG);
+    max30102_Bus_Write(REG_MODE_CONFIG, mode & (uint8_t)~MODE_CONFIG_SHDN);
+}
+
+/// @brief Discard all samples in the FIFO and clear the overflow counter
+void max30102_FIFO_Flush(void)
+{
+    max30102_Bus_Write(REG_FIFO_WR_PTR, 0x00);
+    max30102_Bus_Write(REG_OVF_COUNTER, 0x00);
+    max30102_Bus_Write(REG_FIFO_RD_PTR, 0x00);
+    // Clear pending interrupt status as well
+    max30102_ClearIntStatus();
+}
+
+/// @brief Set the LED pulse amplitudes (0.2mA/LSB), used by the automatic gain control
+/// @param red_pa LED1 (Red) amplitude
+/// @param ir_pa LED2 (IR) amplitude
+void max30102_SetLedAmplitude(uint8_t red_pa, uint8_t ir_pa)
+{
+    max30102_Bus_Write(REG_LED1_PA, red_pa);
+    max30102_Bus_Write(REG_LED2_PA, ir_pa);
+}
+
+/// @brief Set the SpO2 ADC full-scale range, sample rate and pulse width are kept
+/// @param range 0: 2048nA, 1: 4096nA, 2: 8192nA, 3: 16384nA
+void max30102_SetAdcRange(uint8_t range)
+{
+    uint8_t config = max30102_Bus_Read(REG_SPO2_CONFIG);
+    config = (config & (uint8_t)~SPO2_CONFIG_ADC_RGE_MASK) |
+             (uint8_t)((range << SPO2_CONFIG_ADC_RGE_POS) & SPO2_CONFIG_ADC_RGE_MASK);
+    max30102_Bus_Write(REG_SPO2_CONFIG, config);
+}
+
+/// @brief Start one die temperature conversion (about 29ms), completion raises DIE_TEMP_RDY
+/// @note The sensor must not be in shutdown
+void max30102_Temp_Start(void)
+{
+    die_temp_ready = 0;
+    max30102_Bus_Write(REG_TEMP_CONFIG, TEMP_CONFIG_TEMP_EN);
+}
+
+/// @brief Check whether the conversion started by max30102_Temp_Start() has completed
+/// @note Only the status register is read, which the FIFO reads do anyway while sampling
+/// @return 1 if a result is ready
+uint8_t max30102_Temp_IsReady(void)
+{
+    if (!die_temp_ready) {
+        max30102_ClearIntStatus();
+    }
+    return die_temp_ready;
+}
+
+/// @brief Read the die temperature of the last conversion
+/// @return Temperature in 1/16 degC (TINT two's complement, TFRAC 0.0625 degC steps)
+int16_t max30102_Temp_Read(void)
+{
+    int8_t tint = (int8_t)max30102_Bus_Read(REG_TEMP_INTR);
+    uint8_t tfrac = max30102_Bus_Read(REG_TEMP_FRAC) & 0x0F;
+
+    die_temp_ready = 0;
+    return (int16_t)(tint * 16 + tfrac);
+}
+
 void maxim_max30102_write_reg(uint8_t uch_addr, uint8_t uch_data)
 {
     //  char ach_i2c_data[2];
@@ -55,12 +55,40 @@
 #define REG_REV_ID 0xFE
 #define REG_PART_ID 0xFF
 
+#define MODE_CONFIG_SHDN 0x80  // MODE_CONFIG[7]: 关断，LED 与 ADC 停止，寄存器保持
+#define SPO2_CONFIG_ADC_RGE_POS 5
+#define SPO2_CONFIG_ADC_RGE_MASK (0x03 << SPO2_CONFIG_ADC_RGE_POS)  // SPO2_CONFIG[6:5]
+
+#define INTR_ENABLE_2_DIE_TEMP_RDY 0x02  // INTR_ENABLE_2[1]: 芯片温度转换完成中断
+#define INTR_STATUS_2_DIE_TEMP_RDY 0x02  // INTR_STATUS_2[1]，读状态寄存器时清除
+#define TEMP_CONFIG_TEMP_EN 0x01         // TEMP_CONFIG[0]: 启动一次温度转换，完成后自动清零
+
+#define MAX30102_LED_PA_DEFAULT 0x24     // 上电默认 LED 电流（约 7mA，0.2mA/LSB）
+#define MAX30102_ADC_RGE_DEFAULT 1       // 上电默认量程 4096nA
+#define MAX30102_ADC_RGE_MAX 3           // 0: 2048nA, 1: 4096nA, 2: 8192nA, 3: 16384nA
+#define MAX30102_ADC_FULL_SCALE 0x3FFFF  // 18 位 ADC 满量程
+
+#define MAX30102_FIFO_DEPTH 32         // FIFO 深度（样本数）
+#define MAX30102_BYTES_PER_SAMPLE 6    // SpO2 模式下每个样本 Red + IR 共 6 字节
+#define MAX30102_OVF_COUNTER_MAX 0x1F  // OVF_COUNTER[4:0]，饱和计数
+#define MAX30102_SAMPLE_PERIOD_MS 10   // 100Hz 采样
+
 void max30102_init(void);
 void max30102_reset(void);
+void max30102_shutdown(void);
+void max30102_wakeup(void);
+void max30102_FIFO_Flush(void);
+void max30102_SetLedAmplitude(uint8_t red_pa, uint8_t ir_pa);
+void max30102_SetAdcRange(uint8_t range);
+void max30102_Temp_Start(void);
+uint8_t max30102_Temp_IsReady(void);
+int16_t max30102_Temp_Read(void);
 uint8_t max30102_Bus_Write(uint8_t Register_Address, uint8_t Word_Data);
 uint8_t max30102_Bus_Read(uint8_t Register_Address);
 void max30102_FIFO_ReadWords(uint8_t Register_Address, uint16_t Word_Data[][2], uint8_t count);
 void max30102_FIFO_ReadBytes(uint8_t Register_Address, uint8_t *Data);
+uint8_t max30102_FIFO_GetAvailable(uint8_t *pun_overflow);
+uint8_t max30102_FIFO_ReadSamples(uint32_t *pun_red, uint32_t *pun_ir, uint8_t count);
 
 void maxim_max30102_write_reg(uint8_t uch_addr, uint8_t uch_data);
 void maxim_max30102_read_reg(uint8_t uch_addr, uint8_t *puch_data);
@@ -0,0 +1,162 @@
+#include "max30102_agc.h"
+
+#include "max30102.h"
+
+// 单个 LED 通道的直流估计与电流
+typedef struct {
+    uint32_t dc_acc;  // EMA 累加器（直流 << MAX30102_AGC_EMA_SHIFT）
+    uint8_t pa;
+} AgcChannel_t;
+
+// 调整方向
+typedef enum {
+    AGC_HOLD = 0,
+    AGC_UP,
+    AGC_DOWN,
+} AgcDirection_t;
+
+static AgcChannel_t agc_red = {0, MAX30102_LED_PA_DEFAULT};
+static AgcChannel_t agc_ir = {0, MAX30102_LED_PA_DEFAULT};
+static uint8_t agc_range = MAX30102_ADC_RGE_DEFAULT;
+static uint8_t agc_target_pct = MAX30102_AGC_TARGET_PCT;
+static uint16_t agc_hold = 0;    // 自上次调整以来的样本数
+static bool agc_primed = false;  // EMA 是否已用首个样本初始化
+static uint32_t agc_steps = 0;
+
+static uint32_t AGC_Target(void) {
+    return (uint32_t)MAX30102_ADC_FULL_SCALE * agc_target_pct / 100;
+}
+
+/**
+ * @brief 按直流估计计算单个通道的新电流（比例调整，单步最多翻倍/减半）
+ *
+ * @param ch 通道
+ * @param new_pa 输出新电流
+ * @return AgcDirection_t 直流偏离方向，在迟滞带内为 AGC_HOLD
+ */
+static AgcDirection_t AGC_Channel(const AgcChannel_t *ch, uint8_t *new_pa) {
+    uint32_t target = AGC_Target();
+    uint32_t dc = ch->dc_acc >> MAX30102_AGC_EMA_SHIFT;
+    uint32_t pa;
+
+    *new_pa = ch->pa;
+    if (dc * 100 >= target * (100 - MAX30102_AGC_BAND_PCT) &&
+        dc * 100 <= target * (100 + MAX30102_AGC_BAND_PCT)) {
+        return AGC_HOLD;
+    }
+    if (dc == 0) {
+        dc = 1;
+    }
+
+    // 光电流与 LED 电流近似成正比
+    pa = (uint32_t)ch->pa * target / dc;
+    if (pa > (uint32_t)ch->pa * 2)
+        pa = (uint32_t)ch->pa * 2;
+    if (pa < ch->pa / 2u)
+        pa = ch->pa / 2u;
+    if (pa > MAX30102_AGC_PA_MAX)
+        pa = MAX30102_AGC_PA_MAX;
+    if (pa < MAX30102_AGC_PA_MIN)
+        pa = MAX30102_AGC_PA_MIN;
+    *new_pa = (uint8_t)pa;
+
+    return (dc < target) ? AGC_UP : AGC_DOWN;
+}
+
+/**
+ * @brief 恢复上电默认电流与量程（手指检测门限以此为准），清空直流估计
+ */
+void MAX30102_AGC_Reset(void) {
+    if (agc_red.pa != MAX30102_LED_PA_DEFAULT || agc_ir.pa != MAX30102_LED_PA_DEFAULT) {
+        max30102_SetLedAmplitude(MAX30102_LED_PA_DEFAULT, MAX30102_LED_PA_DEFAULT);
+    }
+    if (agc_range != MAX30102_ADC_RGE_DEFAULT) {
+        max30102_SetAdcRange(MAX30102_ADC_RGE_DEFAULT);
+    }
+    agc_red.pa = MAX30102_LED_PA_DEFAULT;
+    agc_ir.pa = MAX30102_LED_PA_DEFAULT;
+    agc_range = MAX30102_ADC_RGE_DEFAULT;
+    agc_hold = 0;
+    agc_primed = false;
+}
+
+/**
+ * @brief 每个样本调用一次，必要时调整 LED 电流或 ADC 量程
+ *        LED 电流已到上限仍偏暗时减小量程，已到下限仍偏亮（强环境光/反射）时增大量程
+ *        Red 与 IR 独立调整，SpO2 使用各自通道的 AC/DC 比值，不受两路增益不同的影响
+ *
+ * @param red Red 样本
+ * @param ir IR 样本
+ * @return true 本样本后增益已改变，此前的样本与之后的样本不连续
+ */
+bool MAX30102_AGC_Update(uint32_t red, uint32_t ir) {
+    AgcDirection_t red_dir, ir_dir;
+    uint8_t red_pa, ir_pa, range;
+
+    if (!agc_primed) {
+        agc_red.dc_acc = red << MAX30102_AGC_EMA_SHIFT;
+        agc_ir.dc_acc = ir << MAX30102_AGC_EMA_SHIFT;
+        agc_primed = true;
+    } else {
+        agc_red.dc_acc += red - (agc_red.dc_acc >> MAX30102_AGC_EMA_SHIFT);
+        agc_ir.dc_acc += ir - (agc_ir.dc_acc >> MAX30102_AGC_EMA_SHIFT);
+    }
+
+    if (agc_hold < MAX30102_AGC_HOLDOFF) {
+        agc_hold++;
+        return false;
+    }
+
+    red_dir = AGC_Channel(&agc_red, &red_pa);
+    ir_dir = AGC_Channel(&agc_ir, &ir_pa);
+
+    range = agc_range;
+    if ((red_dir == AGC_DOWN && red_pa == agc_red.pa) ||
+        (ir_dir == AGC_DOWN && ir_pa == agc_ir.pa)) {
+        // 电流已到下限仍偏亮：增大量程，优先避免削顶
+        if (range < MAX30102_ADC_RGE_MAX)
+            range++;
+    } else if ((red_dir == AGC_UP && red_pa == agc_red.pa) ||
+               (ir_dir == AGC_UP && ir_pa == agc_ir.pa)) {
+        // 电流已到上限仍偏暗：减小量程
+        if (range > 0)
+            range--;
+    }
+
+    if (red_pa == agc_red.pa && ir_pa == agc_ir.pa && range == agc_range) {
+        return false;
+    }
+
+    if (red_pa != agc_red.pa || ir_pa != agc_ir.pa) {
+        max30102_SetLedAmplitude(red_pa, ir_pa);
+        agc_red.pa = red_pa;
+        agc_ir.pa = ir_pa;
+    }
+    if (range != agc_range) {
+        max30102_SetAdcRange(range);
+        agc_range = range;
+    }
+    agc_steps++;
+    agc_hold = 0;
+    agc_primed = false;  // 新增益下重新估计直流
+    return true;
+}
+
+/**
+ * @brief 设置目标直流（满量程百分比，10~90）
+ */
+void MAX30102_AGC_SetTarget(uint8_t target_pct) {
+    if (target_pct >= 10 && target_pct <= 90) {
+        agc_target_pct = target_pct;
+    }
+}
+
+void MAX30102_AGC_GetStatus(MAX30102_AgcStatus_t *status) {
+    status->red_pa = agc_red.pa;
+    status->ir_pa = agc_ir.pa;
+    status->adc_range = agc_range;
+    status->target_pct = agc_target_pct;
+    status->red_dc = agc_red.dc_acc >> MAX30102_AGC_EMA_SHIFT;
+    status->ir_dc = agc_ir.dc_acc >> MAX30102_AGC_EMA_SHIFT;
+    status->steps = agc_steps;
+}
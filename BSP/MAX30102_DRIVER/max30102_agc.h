@@ -0,0 +1,42 @@
+/**
+ * @file max30102_agc.h
+ * @author Shiki
+ * @brief Closed-loop LED current control for the MAX30102.
+ *        Keeps the Red / IR DC level near a configurable fraction of the 18-bit ADC so the
+ *        signal neither clips nor sits at the noise floor. Only run while a finger is present,
+ *        MAX30102_AGC_Reset() restores the power-on current used by the finger detection.
+ * @version 0.1
+ * @date 2025-10-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __MAX30102_AGC_H
+#define __MAX30102_AGC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX30102_AGC_TARGET_PCT 50  // 默认目标直流：满量程的 50%
+#define MAX30102_AGC_BAND_PCT 20    // 迟滞带：直流在目标 ±20% 内不调整
+#define MAX30102_AGC_EMA_SHIFT 4    // 直流估计的 EMA 系数 1/16（约 0.16s 时间常数）
+#define MAX30102_AGC_HOLDOFF 50     // 两次调整之间至少间隔的样本数（0.5s）
+#define MAX30102_AGC_PA_MIN 0x05    // 约 1mA
+#define MAX30102_AGC_PA_MAX 0x7F    // 约 25mA，限制平均功耗
+
+typedef struct {
+    uint8_t red_pa;      // LED1 (Red) 电流
+    uint8_t ir_pa;       // LED2 (IR) 电流
+    uint8_t adc_range;   // SPO2_ADC_RGE
+    uint8_t target_pct;  // 目标直流（满量程百分比）
+    uint32_t red_dc;     // 当前直流估计
+    uint32_t ir_dc;
+    uint32_t steps;      // 累计调整次数
+} MAX30102_AgcStatus_t;
+
+void MAX30102_AGC_Reset(void);
+bool MAX30102_AGC_Update(uint32_t red, uint32_t ir);
+void MAX30102_AGC_SetTarget(uint8_t target_pct);
+void MAX30102_AGC_GetStatus(MAX30102_AgcStatus_t *status);
+
+#endif
@@ -1,10 +1,20 @@
 #include "max30102_user.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include "algorithm.h"
+#include "algorithm_acf.h"
+#include "cycle_counter.h"
 #include "max30102.h"
+#include "max30102_agc.h"
+#include "motion_energy.h"
 #include "oled_hardware_spi.h"
+#include "ppg_dsp.h"
+#include "ppg_hrv.h"
+#include "ramfunc.h"
+#include "sensor_hub.h"
+#include "task_scheduler.h"
 
 #define BUFFER_LENTH 500
 
@@ -14,40 +24,211 @@ int32_t g_spo2;                     // SPO2 value
 int8_t g_spo2_valid;                // indicator to show if the SP02 calculation is valid
 int32_t g_heart_rate;               // heart rate value
 int8_t g_hr_valid;                  // indicator to show if the heart rate calculation is valid
+bool g_ppg_motion;                  // 最近一个窗口因运动过大被跳过
+PpgQuality_t g_ppg_quality;         // 最近一个窗口的灌注指数与信号质量
+
+// 线性化后的分析窗口（按时间顺序 oldest -> newest），静态以节省栈，基准测试复用
+static uint32_t tmp_ir[BUFFER_LENTH];
+static uint32_t tmp_red[BUFFER_LENTH];
+static bool window_ready = false;  // tmp_* 中是否已有完整窗口
+
+typedef void (*HrEngineFunc_t)(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length,
+                               uint32_t *pun_red_buffer, int32_t *pn_spo2, int8_t *pch_spo2_valid,
+                               int32_t *pn_heart_rate, int8_t *pch_hr_valid);
+
+static const HrEngineFunc_t hr_engine_table[HR_ENGINE_COUNT] = {
+    maxim_heart_rate_and_oxygen_saturation,
+    acf_heart_rate_and_oxygen_saturation,
+};
+static const char *const hr_engine_names[HR_ENGINE_COUNT] = {"Maxim", "ACF"};
+
+// 各引擎最近一次计算出的心跳（谷值）位置
+typedef int32_t (*HrBeatFunc_t)(int32_t *pn_locs, int32_t n_max);
+
+static const HrBeatFunc_t hr_beat_table[HR_ENGINE_COUNT] = {
+    maxim_get_beat_locs,
+    acf_get_beat_locs,
+};
+
+typedef void (*PreprocFunc_t)(const int32_t *pn_x, int32_t *pn_y, int32_t n_size);
+
+static const struct {
+    const char *name;
+    PreprocFunc_t func;
+} preproc_table[PREPROC_IMPL_COUNT] = {
+    {"Legacy", ppg_valley_filter_legacy},
+    {"Reference", ppg_valley_filter_ref},
+    {"Fused", ppg_valley_filter},
+};
+
+// 环形缓冲区状态
+static uint16_t write_index = 0;  // 下一个写入位置（0..BUFFER_LENTH-1）
+static uint16_t filled = 0;       // 已填充的样本数量（<= BUFFER_LENTH）
+static uint16_t new_count = 0;    // 自上次分析以来新增样本数
+static uint16_t contiguous = 0;   // 自上次不连续（增益调整等）以来的样本数，饱和于 BUFFER_LENTH
+
+static MAX30102_State_t ppg_state = MAX30102_STATE_DETECT;
+static uint8_t finger_count = 0;  // 手指检测去抖计数
+
+static MAX30102_AcqStats_t acq_stats;
+static uint32_t sample_tick = 0;  // 最近读出的样本的采样时刻 (ms)
+static uint32_t window_tick = 0;  // 最近一次分析窗口中最新样本的采样时刻 (ms)
+// FIFO 未开启回绕，溢出时丢失的是 FIFO 中样本之后的新样本：溢出时积压的样本读完后才是断点
+static uint8_t gap_backlog = 0;  // 断点之前尚未读出的样本数
+static bool gap_pending = false;
+
+// 芯片温度缓存
+static volatile bool int_edge = false;  // INT 引脚下降沿（EXTI 中设置）
+static bool temp_pending = false;       // 已启动转换，等待 DIE_TEMP_RDY
+static uint32_t temp_start_tick = 0;
+static int16_t die_temp = 0;  // 1/16 degC
+static uint32_t die_temp_tick = 0;
+static bool die_temp_valid = false;
+
+static HrEngine_t hr_engine = HR_ENGINE_MAXIM;
+static uint32_t analysis_cycles = 0;  // 最近一次分析的 DWT 周期数
 
 /**
- * @brief MAX30102系统初始化
- *
+ * @brief 清空分析窗口，重新开始填充
  */
-void MAX30102_System_Init(void) {
-    max30102_init();  // max30102初始化
-    uint32_t un_min, un_max;
-    int i;
-    uint8_t temp[6];
+static void MAX30102_ResetWindow(void) {
+    write_index = 0;
+    filled = 0;
+    new_count = 0;
+    contiguous = 0;
+    g_hr_valid = 0;
+    g_spo2_valid = 0;
+    ppg_quality_reset();
+    ppg_hrv_break();
+}
 
-    un_min = 0x3FFFF;
-    un_max = 0;
+/**
+ * @brief 标记采样序列不连续，跨越该点的窗口不参与分析
+ */
+static void MAX30102_MarkDiscontinuity(void) {
+    new_count = 0;
+    contiguous = 0;
+    ppg_quality_reset();
+    ppg_hrv_break();
+}
 
-    // 读取前500个样本，并确定信号范围
-    for (i = 0; i < BUFFER_LENTH; i++) {
-        while (HAL_GPIO_ReadPin(MAX30102_INT_GPIO_Port, MAX30102_INT_Pin) == SET)  // 等待中断引脚
-            ;
+/**
+ * @brief 手指检测（IR 直流门限 + 连续样本去抖），手指离开时丢弃当前窗口
+ *
+ * @param ir_val 当前 IR 样本
+ * @return true 当前样本可用于分析
+ */
+static bool MAX30102_FingerDetect(uint32_t ir_val) {
+    if (ppg_state == MAX30102_STATE_DETECT) {
+        finger_count = (ir_val >= MAX30102_FINGER_ON_THRESHOLD) ? finger_count + 1 : 0;
+        if (finger_count < MAX30102_FINGER_DEBOUNCE) {
+            return false;
+        }
+        finger_count = 0;
+        MAX30102_ResetWindow();
+        ppg_state = MAX30102_STATE_FILLING;
+        return true;
+    }
+    finger_count = (ir_val < MAX30102_FINGER_OFF_THRESHOLD) ? finger_count + 1 : 0;
+    if (finger_count >= MAX30102_FINGER_DEBOUNCE) {
+        finger_count = 0;
+        MAX30102_ResetWindow();
+        MAX30102_AGC_Reset();  // 恢复默认电流，使检测门限重新有效
+        ppg_state = MAX30102_STATE_DETECT;
+        return false;
+    }
+    return true;
+}
 
-        max30102_FIFO_ReadBytes(REG_FIFO_DATA, temp);  // 读取传感器数据，赋值到temp中
-        red_buffer[i] = (long)((long)((long)temp[0] & 0x03) << 16) | (long)temp[1] << 8 |
-                        (long)temp[2];  // 将值合并得到实际数字
-        ir_buffer[i] = (long)((long)((long)temp[3] & 0x03) << 16) | (long)temp[4] << 8 |
-                       (long)temp[5];  // 将值合并得到实际数字
+/**
+ * @brief SpO2 温度补偿
+ *
+ * @param spo2 引擎计算出的 SpO2 (%)
+ * @param temp_q4 芯片温度 (1/16 degC)
+ * @return 补偿后的 SpO2，限制在 0~100
+ */
+static int32_t MAX30102_CompensateSpo2(int32_t spo2, int16_t temp_q4) {
+    int32_t delta_q4 = temp_q4 - MAX30102_SPO2_TEMP_REF_C * 16;
+
+    spo2 -= MAX30102_SPO2_TEMP_COEF * delta_q4 / (16 * 100);
+    if (spo2 < 0)
+        spo2 = 0;
+    if (spo2 > 100)
+        spo2 = 100;
+    return spo2;
+}
 
-        if (un_min > red_buffer[i])
-            un_min = red_buffer[i];  // 更新信号最小值
-        if (un_max < red_buffer[i])
-            un_max = red_buffer[i];  // 更新信号最大值
+/**
+ * @brief 使用当前选择的引擎分析窗口，并记录耗时
+ */
+static void MAX30102_Analyze(uint32_t *ir, uint32_t *red) {
+    int32_t beats[ACF_MAX_BEATS];
+    int32_t beat_count;
+    uint32_t start = CycleCounter_Get();
+
+    hr_engine_table[hr_engine](ir, BUFFER_LENTH, red, &g_spo2, &g_spo2_valid, &g_heart_rate,
+                               &g_hr_valid);
+    analysis_cycles = CycleCounter_Get() - start;
+    // 使用异步采集缓存的芯片温度，尚未取得温度时不补偿
+    if ((1 == g_spo2_valid) && die_temp_valid) {
+        g_spo2 = MAX30102_CompensateSpo2(g_spo2, die_temp);
     }
 
-    // 计算前500个样本后的心率和SpO2（样本的前5秒）
-    maxim_heart_rate_and_oxygen_saturation(ir_buffer, BUFFER_LENTH, red_buffer, &g_spo2,
-                                           &g_spo2_valid, &g_heart_rate, &g_hr_valid);
+    // 心跳间期的规律性计入信号质量
+    beat_count = hr_beat_table[hr_engine](beats, ACF_MAX_BEATS);
+    ppg_quality_apply_beats(&g_ppg_quality, beats, beat_count);
+
+    // 有效窗口的心跳换算为绝对时刻送入 RR 序列，重叠窗口重复报告的心跳由 ppg_hrv 去重
+    // 窗口末尾的心跳可能因滤波延迟尚未完整出现，留给下一个窗口
+    if ((1 == g_hr_valid) && (g_ppg_quality.sqi >= PPG_QUALITY_SQI_MIN)) {
+        for (int32_t k = 0; k < beat_count; k++) {
+            if (beats[k] >= BUFFER_LENTH - MAX30102_HRV_EDGE_SAMPLES)
+                break;
+            ppg_hrv_add_beat(window_tick -
+                             (uint32_t)(BUFFER_LENTH - 1 - beats[k]) * MAX30102_SAMPLE_PERIOD_MS);
+        }
+    } else {
+        ppg_hrv_break();
+    }
+}
+
+/**
+ * @brief MAX30102系统初始化，仅配置芯片后立即返回
+ *        500 个样本的窗口在检测到手指后由 Task_BloodMeasure 非阻塞地填充
+ */
+void MAX30102_System_Init(void) {
+    max30102_init();  // max30102初始化
+    ppg_state = MAX30102_STATE_DETECT;
+    finger_count = 0;
+    MAX30102_ResetWindow();
+    MAX30102_AGC_Reset();
+    ppg_hrv_reset();
+}
+
+/**
+ * @brief 挂起测量：暂停测量任务并关断传感器（SHDN），停止 LED 电流与 FIFO 溢出
+ */
+void MAX30102_Suspend(void) {
+    TaskScheduler_SuspendTask("Blood_Measure_Task");
+    max30102_shutdown();
+    temp_pending = false;  // 关断后转换不会完成，缓存值保留
+    ppg_state = MAX30102_STATE_SHUTDOWN;
+}
+
+/**
+ * @brief 恢复测量：唤醒传感器，丢弃 FIFO 中的旧数据并从手指检测重新开始填充窗口
+ */
+void MAX30102_Resume(void) {
+    max30102_wakeup();
+    max30102_FIFO_Flush();
+    gap_pending = false;
+    sample_tick = HAL_GetTick();
+    finger_count = 0;
+    MAX30102_ResetWindow();
+    MAX30102_AGC_Reset();
+    acq_stats.last_tick = 0;  // 挂起期间不计入读取间隔
+    ppg_state = MAX30102_STATE_DETECT;
+    TaskScheduler_ResumeTask("Blood_Measure_Task");
 }
 
 #if 0
@@ -88,39 +269,108 @@ void Task_BloodMeasure(void) {
 }
 #endif
 
-// 可调参数：每次函数最多读取多少样本（根据实时性/开销调整）
+// 可调参数：每次函数最多读取多少样本（根据实时性/开销调整，不超过 FIFO 深度）
 #ifndef SAMPLE_BATCH
 #define SAMPLE_BATCH 10
 #endif
 
+/**
+ * @brief 记录一次 FIFO 读取的时刻、积压与溢出
+ *
+ * @param backlog 读取前 FIFO 中的样本数
+ * @param overflow 读取前 OVF_COUNTER 的值
+ * @param tick 读取时刻
+ */
+static void MAX30102_AccountBurst(uint8_t backlog, uint8_t overflow, uint32_t tick) {
+    if (backlog > acq_stats.max_backlog)
+        acq_stats.max_backlog = backlog;
+    if (overflow) {
+        // 溢出期间的样本已丢失，断点在当前积压的样本之后，读完积压后再标记
+        // 上一个断点尚未读到时提前标记，跨越两个断点的窗口同样被跳过
+        acq_stats.overflows++;
+        acq_stats.dropped += overflow;
+        if (gap_pending)
+            MAX30102_MarkDiscontinuity();
+        gap_backlog = backlog;
+        gap_pending = true;
+    }
+    if (acq_stats.last_tick != 0 && tick - acq_stats.last_tick > acq_stats.max_interval_ms)
+        acq_stats.max_interval_ms = tick - acq_stats.last_tick;
+    acq_stats.last_tick = tick;
+    acq_stats.bursts++;
+}
+
+/**
+ * @brief 芯片温度的异步采集：按周期启动转换，INT 下降沿后检查 DIE_TEMP_RDY 并取回结果
+ *        INT 同时用于 FIFO 中断，状态位由驱动在读状态寄存器时锁存
+ *
+ * @param now 当前系统时刻 (ms)
+ */
+static void MAX30102_TempUpdate(uint32_t now) {
+    if (temp_pending) {
+        bool timeout = (now - temp_start_tick) > MAX30102_TEMP_TIMEOUT_MS;
+        if (!int_edge && !timeout)
+            return;
+        int_edge = false;
+        if (max30102_Temp_IsReady()) {
+            die_temp = max30102_Temp_Read();
+            die_temp_tick = now;
+            die_temp_valid = true;
+            temp_pending = false;
+            SensorHub_Publish(SENSOR_CH_PPG_TEMP, &die_temp, now);
+        } else if (timeout) {
+            temp_pending = false;  // 放弃本次转换，下个周期重试
+        }
+        return;
+    }
+    if (!die_temp_valid || (now - die_temp_tick) >= MAX30102_TEMP_PERIOD_MS) {
+        max30102_Temp_Start();
+        temp_start_tick = now;
+        temp_pending = true;
+    }
+}
+
 void Task_BloodMeasure(void) {
-    uint8_t temp[6];
-    uint16_t i;
-    // 静态持久化变量（保留在函数间）
-    static uint16_t write_index = 0;  // 下一个写入位置（0..BUFFER_LENTH-1）
-    static uint16_t filled = 0;       // 已填充的样本数量（<= BUFFER_LENTH）
-    static uint16_t new_count = 0;    // 自上次分析以来新增样本数
-
-    // 临时线性化数组（静态以节省栈）
-    static uint32_t tmp_ir[BUFFER_LENTH];
-    static uint32_t tmp_red[BUFFER_LENTH];
-
-    // 每次最多读取 SAMPLE_BATCH 条数据；若没有数据则立即返回（非阻塞）
-    for (i = 0; i < SAMPLE_BATCH; i++) {
-        while (HAL_GPIO_ReadPin(MAX30102_INT_GPIO_Port, MAX30102_INT_Pin) == SET)
-            ;
-        // 读取一帧 FIFO 数据（6 字节）
-        max30102_FIFO_ReadBytes(REG_FIFO_DATA, temp);
+    uint32_t red_batch[SAMPLE_BATCH];
+    uint32_t ir_batch[SAMPLE_BATCH];
+    uint8_t count, backlog, overflow;
+    uint32_t tick;
+
+    MAX30102_TempUpdate(HAL_GetTick());
+
+    // 按 FIFO 读写指针获取已就绪样本数，没有数据立即返回（非阻塞）
+    backlog = max30102_FIFO_GetAvailable(&overflow);
+    count = (backlog > SAMPLE_BATCH) ? SAMPLE_BATCH : backlog;
+    tick = HAL_GetTick();
+    count = max30102_FIFO_ReadSamples(red_batch, ir_batch, count);
+    if (count == 0)
+        return;
+    MAX30102_AccountBurst(backlog, overflow, tick);
+    acq_stats.samples += count;
+    if (gap_pending && count <= gap_backlog) {
+        // 本批都在断点之前，FIFO 已满的时刻未知，接着上一批的采样时刻推算
+        sample_tick += (uint32_t)count * MAX30102_SAMPLE_PERIOD_MS;
+    } else {
+        // FIFO 中还剩 backlog - count 个连续的样本，本批最新样本的采样时刻相应提前
+        sample_tick = tick - (uint32_t)(backlog - count) * MAX30102_SAMPLE_PERIOD_MS;
+    }
 
-        // 合并为 18-bit 数据（和你原来合并方式一致）
-        uint32_t red_val =
-            ((uint32_t)(temp[0] & 0x03) << 16) | ((uint32_t)temp[1] << 8) | (uint32_t)temp[2];
-        uint32_t ir_val =
-            ((uint32_t)(temp[3] & 0x03) << 16) | ((uint32_t)temp[4] << 8) | (uint32_t)temp[5];
+    for (uint8_t i = 0; i < count; i++) {
+        if (gap_pending) {
+            if (gap_backlog == 0) {
+                MAX30102_MarkDiscontinuity();
+                gap_pending = false;
+            } else {
+                gap_backlog--;
+            }
+        }
+        if (!MAX30102_FingerDetect(ir_batch[i]))
+            continue;
 
         // 写入环形缓冲区
-        red_buffer[write_index] = red_val;
-        ir_buffer[write_index] = ir_val;
+        red_buffer[write_index] = red_batch[i];
+        ir_buffer[write_index] = ir_batch[i];
+        ppg_quality_add_sample(ir_batch[i]);
 
         // 更新索引与计数
         write_index++;
@@ -129,12 +379,53 @@ void Task_BloodMeasure(void) {
 
         if (filled < BUFFER_LENTH)
             filled++;
+        if (filled >= BUFFER_LENTH)
+            ppg_state = MAX30102_STATE_MEASURING;
 
         new_count++;
+        if (contiguous < BUFFER_LENTH)
+            contiguous++;
+
+        // 自动增益：调整后的样本与之前的样本不可比，整个窗口需要重新积累
+        // FIFO 与本批次剩余样本仍是旧增益下采集的，一并丢弃
+        if (MAX30102_AGC_Update(red_batch[i], ir_batch[i])) {
+            MAX30102_MarkDiscontinuity();
+            max30102_FIFO_Flush();
+            gap_pending = false;
+            break;
+        }
     }
 
     // 仅在缓冲区已满并且累计新样本 >= 100 时才做一次完整分析
     if ((filled >= BUFFER_LENTH) && (new_count >= 100)) {
+        // 运动门控：窗口期内手臂运动过大时结果必然无效，直接跳过分析
+        g_ppg_motion = MotionEnergy_IsMoving();
+        if (g_ppg_motion) {
+            g_hr_valid = 0;
+            g_spo2_valid = 0;
+            new_count = 0;
+            ppg_hrv_break();
+            return;
+        }
+
+        // 窗口跨越增益调整或样本丢失，跳过本次分析
+        if (contiguous < BUFFER_LENTH) {
+            acq_stats.skipped_windows++;
+            g_hr_valid = 0;
+            g_spo2_valid = 0;
+            new_count = 0;
+            return;
+        }
+
+        // 信号质量由采集时累计的块统计得到，质量太差时省去完整的峰值搜索
+        if (ppg_quality_evaluate(&g_ppg_quality) && g_ppg_quality.sqi < PPG_QUALITY_SQI_MIN) {
+            g_hr_valid = 0;
+            g_spo2_valid = 0;
+            new_count = 0;
+            ppg_hrv_break();
+            return;
+        }
+
         // 将环形缓冲线性化为 tmp_*：按时间顺序 oldest -> newest
         // oldest 索引就是 write_index（因为 write_index 指向下一个将被覆盖的位置）
         for (uint16_t k = 0; k < BUFFER_LENTH; k++) {
@@ -145,9 +436,11 @@ void Task_BloodMeasure(void) {
             tmp_red[k] = red_buffer[idx];
         }
 
+        window_ready = true;
+        window_tick = sample_tick;
+
         // 调用分析函数（使用线性化数组）
-        maxim_heart_rate_and_oxygen_saturation(tmp_ir, BUFFER_LENTH, tmp_red, &g_spo2,
-                                               &g_spo2_valid, &g_heart_rate, &g_hr_valid);
+        MAX30102_Analyze(tmp_ir, tmp_red);
 
         // 重置新增样本计数（等待下一个 100 个新样本）
         new_count = 0;
@@ -155,7 +448,8 @@ void Task_BloodMeasure(void) {
 }
 
 bool MAX30102_IsVaid(void) {
-    if ((1 == g_hr_valid) && (1 == g_spo2_valid) && (g_heart_rate < 120) && (g_spo2 < 101)) {
+    if (!g_ppg_motion && (g_ppg_quality.sqi >= PPG_QUALITY_SQI_MIN) && (1 == g_hr_valid) &&
+        (1 == g_spo2_valid) && (g_heart_rate < 120) && (g_spo2 < 101)) {
         // printf("HeartRate=%i, BloodOxyg=%i\r\n", g_heart_rate, g_spo2);
         // char buffer[20];
         // snprintf(buffer, sizeof(buffer), "HR=%3d, SpO2=%3d", g_heart_rate, g_spo2);
@@ -165,6 +459,167 @@ bool MAX30102_IsVaid(void) {
     return false;
 }
 
+/**
+ * @brief 当前采集状态
+ */
+MAX30102_State_t MAX30102_GetState(void) {
+    return ppg_state;
+}
+
+/**
+ * @brief 分析窗口填充进度（0~100）
+ */
+uint8_t MAX30102_GetFillPercent(void) {
+    return (uint8_t)((uint32_t)filled * 100 / BUFFER_LENTH);
+}
+
+/**
+ * @brief 切换心率/血氧计算引擎，下一个分析窗口生效
+ */
+void MAX30102_SetHrEngine(HrEngine_t engine) {
+    if (engine < HR_ENGINE_COUNT) {
+        hr_engine = engine;
+    }
+}
+
+HrEngine_t MAX30102_GetHrEngine(void) {
+    return hr_engine;
+}
+
+const char *MAX30102_GetHrEngineName(HrEngine_t engine) {
+    return (engine < HR_ENGINE_COUNT) ? hr_engine_names[engine] : "?";
+}
+
+/**
+ * @brief 最近一次分析消耗的 CPU 周期数
+ */
+uint32_t MAX30102_GetAnalysisCycles(void) {
+    return analysis_cycles;
+}
+
+/**
+ * @brief 在最近一次分析的同一窗口上依次运行所有引擎，对比结果与耗时
+ *
+ * @param results 每个引擎的结果，按 HrEngine_t 索引
+ * @return false 尚无完整窗口
+ */
+bool MAX30102_BenchmarkEngines(HrEngineResult_t results[HR_ENGINE_COUNT]) {
+    if (!window_ready) {
+        return false;
+    }
+    for (uint8_t e = 0; e < HR_ENGINE_COUNT; e++) {
+        uint32_t start = CycleCounter_Get();
+        hr_engine_table[e](tmp_ir, BUFFER_LENTH, tmp_red, &results[e].spo2,
+                           &results[e].spo2_valid, &results[e].heart_rate, &results[e].hr_valid);
+        results[e].cycles = CycleCounter_Get() - start;
+    }
+    return true;
+}
+
+/**
+ * @brief 采集统计
+ */
+const MAX30102_AcqStats_t *MAX30102_GetAcqStats(void) {
+    return &acq_stats;
+}
+
+void MAX30102_ClearAcqStats(void) {
+    memset(&acq_stats, 0, sizeof(acq_stats));
+}
+
+/**
+ * @brief 最近一次分析窗口中最新样本的采样时刻 (ms)，窗口覆盖此前 BUFFER_LENTH 个采样周期
+ */
+uint32_t MAX30102_GetWindowTick(void) {
+    return window_tick;
+}
+
+/**
+ * @brief MAX30102 INT 引脚下降沿（EXTI 回调中调用），只记录边沿，I2C 访问留给测量任务
+ */
+void MAX30102_IntHandler(void) {
+    int_edge = true;
+}
+
+/**
+ * @brief 在最近一次分析的 IR 窗口上依次运行各预处理实现，对比耗时
+ *
+ * @param results 每个实现的名称与耗时
+ * @return false 尚无完整窗口
+ */
+static int32_t bench_out[BUFFER_LENTH];  // 基准测试的输出缓冲
+
+bool MAX30102_BenchmarkPreprocess(PreprocBenchResult_t results[PREPROC_IMPL_COUNT]) {
+    if (!window_ready) {
+        return false;
+    }
+    for (uint8_t i = 0; i < PREPROC_IMPL_COUNT; i++) {
+        uint32_t start = CycleCounter_Get();
+        preproc_table[i].func((const int32_t *)tmp_ir, bench_out, BUFFER_LENTH);
+        results[i].cycles = CycleCounter_Get() - start;
+        results[i].name = preproc_table[i].name;
+    }
+    return true;
+}
+
+/**
+ * @brief 在最近一次分析的窗口上分别运行各热点函数的 flash 与 SRAM 版本，对比耗时
+ *        结果用于决定 ramfunc.h 中的放置选择，需要 RAMFUNC_BENCHMARK
+ *
+ * @param results 每个函数的名称与两种放置下的耗时
+ * @return false 尚无完整窗口、未编译 RAM 版本，或链接时 .RamFunc 未放到 SRAM
+ */
+bool MAX30102_BenchmarkPlacement(PlacementBenchResult_t results[PLACEMENT_FUNC_COUNT]) {
+#if RAMFUNC_BENCHMARK
+    int32_t locs_flash[15], locs_ram[15];
+    volatile int32_t sink;
+    uint32_t start;
+
+    if (!window_ready) {
+        return false;
+    }
+    // 没有放置 .RamFunc 的链接配置（MDK 默认布局）下"RAM 版本"仍在 flash 中，对比没有意义
+    if (!RAMFUNC_IN_SRAM(ppg_valley_filter_ram) || !RAMFUNC_IN_SRAM(acf_lag_mean_ram) ||
+        !RAMFUNC_IN_SRAM(maxim_sort_indices_descend_ram)) {
+        return false;
+    }
+
+    results[0].name = "valley_filter";
+    start = CycleCounter_Get();
+    ppg_valley_filter_flash((const int32_t *)tmp_ir, bench_out, BUFFER_LENTH);
+    results[0].flash_cycles = CycleCounter_Get() - start;
+    start = CycleCounter_Get();
+    ppg_valley_filter_ram((const int32_t *)tmp_ir, bench_out, BUFFER_LENTH);
+    results[0].ram_cycles = CycleCounter_Get() - start;
+
+    // 滤波输出幅度很小，作为自相关输入不会溢出；取 ACF 引擎中最长的滞后
+    results[1].name = "acf_lag_mean";
+    start = CycleCounter_Get();
+    sink = acf_lag_mean_flash(bench_out, BUFFER_LENTH / ACF_DECIMATION, ACF_LAG_MAX);
+    results[1].flash_cycles = CycleCounter_Get() - start;
+    start = CycleCounter_Get();
+    sink = acf_lag_mean_ram(bench_out, BUFFER_LENTH / ACF_DECIMATION, ACF_LAG_MAX);
+    results[1].ram_cycles = CycleCounter_Get() - start;
+    (void)sink;
+
+    // 与 maxim_remove_close_peaks 相同的规模：最多 15 个峰值
+    results[2].name = "sort_indices";
+    for (int32_t k = 0; k < 15; k++) {
+        locs_flash[k] = locs_ram[k] = k * 30;
+    }
+    start = CycleCounter_Get();
+    maxim_sort_indices_descend_flash(bench_out, locs_flash, 15);
+    results[2].flash_cycles = CycleCounter_Get() - start;
+    start = CycleCounter_Get();
+    maxim_sort_indices_descend_ram(bench_out, locs_ram, 15);
+    results[2].ram_cycles = CycleCounter_Get() - start;
+    return true;
+#else
+    (void)results;
+    return false;
+#endif
+}
+
 void max30102_test(void) {
     uint32_t un_min, un_max;
     int i;
@@ -4,14 +4,104 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "ppg_quality.h"
+
 extern int32_t g_spo2;                     // SPO2 value
 extern int8_t g_spo2_valid;                // indicator to show if the SP02 calculation is valid
 extern int32_t g_heart_rate;               // heart rate value
 extern int8_t g_hr_valid;                  // indicator to show if the heart rate calculation is valid
+extern bool g_ppg_motion;                  // 最近一个窗口因运动过大被跳过
+extern PpgQuality_t g_ppg_quality;         // 最近一个窗口的灌注指数与信号质量
+
+// 手指检测：IR 直流高于 ON 门限连续 DEBOUNCE 个样本视为手指放上，低于 OFF 门限视为离开
+#define MAX30102_FINGER_ON_THRESHOLD 50000
+#define MAX30102_FINGER_OFF_THRESHOLD 30000
+#define MAX30102_FINGER_DEBOUNCE 10
+
+// 芯片温度：测量期间每 PERIOD 启动一次转换，由 DIE_TEMP_RDY 中断取回结果
+#define MAX30102_TEMP_PERIOD_MS 1000
+#define MAX30102_TEMP_TIMEOUT_MS 100  // 转换约 29ms，超时未完成则重新启动
+// SpO2 温度补偿：SpO2 -= COEF * (T - REF)，COEF 单位 0.01% / degC，为 0 时不补偿
+// LED 波长随温度漂移，两个常数需对照参考血氧仪在不同温度下标定后在工程选项中覆盖
+#ifndef MAX30102_SPO2_TEMP_REF_C
+#define MAX30102_SPO2_TEMP_REF_C 30
+#endif
+#ifndef MAX30102_SPO2_TEMP_COEF
+#define MAX30102_SPO2_TEMP_COEF 0
+#endif
+
+// 窗口最后 HRV_EDGE_SAMPLES 个样本内的心跳不送入 RR 序列（滤波延迟导致位置不可靠）
+#define MAX30102_HRV_EDGE_SAMPLES 20
+
+// 采集状态
+typedef enum {
+    MAX30102_STATE_SHUTDOWN = 0,  // 测量挂起，传感器关断
+    MAX30102_STATE_DETECT,        // 等待手指
+    MAX30102_STATE_FILLING,       // 已检测到手指，正在填充 500 个样本的窗口
+    MAX30102_STATE_MEASURING      // 窗口已满，每 100 个新样本分析一次
+} MAX30102_State_t;
+
+// 心率/血氧计算引擎，可在运行时切换
+typedef enum {
+    HR_ENGINE_MAXIM = 0,  // Maxim 谷值检测（滑动平均 + 差分 + Hamming）
+    HR_ENGINE_ACF,        // 抽取自相关
+    HR_ENGINE_COUNT
+} HrEngine_t;
+
+// 单个引擎在同一窗口上的计算结果及耗时
+typedef struct {
+    int32_t heart_rate;
+    int32_t spo2;
+    int8_t hr_valid;
+    int8_t spo2_valid;
+    uint32_t cycles;  // DWT 周期数
+} HrEngineResult_t;
+
+// 采集统计，用于确认 FIFO 读取跟得上采样
+typedef struct {
+    uint32_t samples;          // 已读取样本数
+    uint32_t bursts;           // 非空 FIFO 读取次数
+    uint32_t overflows;        // 检测到 FIFO 溢出的次数
+    uint32_t dropped;          // 丢失样本数（OVF_COUNTER 饱和时为下限）
+    uint32_t skipped_windows;  // 因采样不连续跳过的分析窗口数
+    uint32_t max_interval_ms;  // 相邻两次非空读取的最大间隔
+    uint32_t last_tick;        // 最近一次读取的系统时刻 (ms)
+    uint8_t max_backlog;       // 观察到的最大 FIFO 积压
+} MAX30102_AcqStats_t;
+
+// 预处理（谷值滤波）实现的耗时对比
+#define PREPROC_IMPL_COUNT 3
+typedef struct {
+    const char *name;
+    uint32_t cycles;  // DWT 周期数
+} PreprocBenchResult_t;
+
+// 热点函数在 flash / SRAM 中执行的耗时对比
+#define PLACEMENT_FUNC_COUNT 3
+typedef struct {
+    const char *name;
+    uint32_t flash_cycles;
+    uint32_t ram_cycles;
+} PlacementBenchResult_t;
 
 void MAX30102_System_Init(void);
+void MAX30102_Suspend(void);
+void MAX30102_Resume(void);
 void Task_BloodMeasure(void);
 bool MAX30102_IsVaid(void);
 void max30102_test(void);
+MAX30102_State_t MAX30102_GetState(void);
+uint8_t MAX30102_GetFillPercent(void);
+void MAX30102_SetHrEngine(HrEngine_t engine);
+HrEngine_t MAX30102_GetHrEngine(void);
+const char *MAX30102_GetHrEngineName(HrEngine_t engine);
+uint32_t MAX30102_GetAnalysisCycles(void);
+bool MAX30102_BenchmarkEngines(HrEngineResult_t results[HR_ENGINE_COUNT]);
+bool MAX30102_BenchmarkPreprocess(PreprocBenchResult_t results[PREPROC_IMPL_COUNT]);
+bool MAX30102_BenchmarkPlacement(PlacementBenchResult_t results[PLACEMENT_FUNC_COUNT]);
+const MAX30102_AcqStats_t *MAX30102_GetAcqStats(void);
+void MAX30102_ClearAcqStats(void);
+uint32_t MAX30102_GetWindowTick(void);
+void MAX30102_IntHandler(void);
 
 #endif
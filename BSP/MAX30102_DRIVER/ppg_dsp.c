@@ -0,0 +1,289 @@
+/**
+ * @file    ppg_dsp.c
+ * @brief   Block-processing filter kernels for the PPG preprocessing chain
+ * @version V1.0
+ * @date    2025-10-21
+ * @note    Naming follows the Maxim conventions used in algorithm.c (n_ / an_ / pn_ ...).
+ */
+#include "ppg_dsp.h"
+
+#include <string.h>
+
+#include "ramfunc.h"
+
+// 41, 276, 512, 276, 41 (和 1146) 重新缩放到和为 1024，归一化只需右移
+const int16_t aw_ppg_hamming_neg[5] = {-37, -246, -458, -246, -37};
+
+// legacy 实现使用的原始系数
+static const int32_t an_legacy_hamm[5] = {41, 276, 512, 276, 41};
+
+void ppg_ma4_init(PpgMa4_t *ps_st)
+{
+    memset(ps_st, 0, sizeof(*ps_st));
+}
+
+void ppg_ma4_process(PpgMa4_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size)
+/**
+ * \brief        4-point moving sum, out[n] = x[n] + x[n-1] + x[n-2] + x[n-3]
+ * \par          Details
+ *               pn_out may equal pn_in.
+ *
+ * \retval       None
+ */
+{
+    int32_t n_h0 = ps_st->an_hist[0], n_h1 = ps_st->an_hist[1], n_h2 = ps_st->an_hist[2];
+    int32_t k, n_x;
+
+    for (k = 0; k < n_size; k++) {
+        n_x = pn_in[k];
+        pn_out[k] = n_x + n_h0 + n_h1 + n_h2;
+        n_h2 = n_h1;
+        n_h1 = n_h0;
+        n_h0 = n_x;
+    }
+    ps_st->an_hist[0] = n_h0;
+    ps_st->an_hist[1] = n_h1;
+    ps_st->an_hist[2] = n_h2;
+}
+
+void ppg_diff_init(PpgDiff_t *ps_st)
+{
+    ps_st->n_prev = 0;
+}
+
+void ppg_diff_process(PpgDiff_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size)
+/**
+ * \brief        First difference, out[n] = x[n] - x[n-1], pn_out may equal pn_in
+ *
+ * \retval       None
+ */
+{
+    int32_t n_prev = ps_st->n_prev;
+    int32_t k, n_x;
+
+    for (k = 0; k < n_size; k++) {
+        n_x = pn_in[k];
+        pn_out[k] = n_x - n_prev;
+        n_prev = n_x;
+    }
+    ps_st->n_prev = n_prev;
+}
+
+void ppg_ma2_init(PpgMa2_t *ps_st)
+{
+    ps_st->n_prev = 0;
+}
+
+void ppg_ma2_process(PpgMa2_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size)
+/**
+ * \brief        2-point moving sum, out[n] = x[n] + x[n-1], pn_out may equal pn_in
+ *
+ * \retval       None
+ */
+{
+    int32_t n_prev = ps_st->n_prev;
+    int32_t k, n_x;
+
+    for (k = 0; k < n_size; k++) {
+        n_x = pn_in[k];
+        pn_out[k] = n_x + n_prev;
+        n_prev = n_x;
+    }
+    ps_st->n_prev = n_prev;
+}
+
+void ppg_fir_init(PpgFir_t *ps_st, const int16_t *pw_taps, uint8_t uch_taps, uint8_t uch_shift)
+{
+    memset(ps_st, 0, sizeof(*ps_st));
+    ps_st->pw_taps = pw_taps;
+    ps_st->uch_taps = (uch_taps > PPG_FIR_MAX_TAPS) ? PPG_FIR_MAX_TAPS : uch_taps;
+    ps_st->uch_shift = uch_shift;
+}
+
+void ppg_fir_process(PpgFir_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size)
+/**
+ * \brief        Direct form FIR, out[n] = (sum taps[j] * x[n-j]) >> shift
+ * \par          Details
+ *               an_hist[0] is x[n-1]. pn_out may equal pn_in.
+ *
+ * \retval       None
+ */
+{
+    const int16_t *pw_taps = ps_st->pw_taps;
+    int32_t n_taps = ps_st->uch_taps;
+    int32_t k, j, n_x, n_acc;
+
+    for (k = 0; k < n_size; k++) {
+        n_x = pn_in[k];
+        n_acc = pw_taps[0] * n_x;
+        for (j = 1; j < n_taps; j++)
+            n_acc += pw_taps[j] * ps_st->an_hist[j - 1];
+        for (j = n_taps - 2; j > 0; j--)
+            ps_st->an_hist[j] = ps_st->an_hist[j - 1];
+        ps_st->an_hist[0] = n_x;
+        pn_out[k] = n_acc >> ps_st->uch_shift;
+    }
+}
+
+void ppg_valley_filter_ref(const int32_t *pn_x, int32_t *pn_y, int32_t n_size)
+/**
+ * \brief        Valley filter through the separate reference stages
+ * \par          Details
+ *               Feeds the chain in small blocks to exercise the stateful interface, the first
+ *               PPG_VALLEY_FILTER_DELAY outputs are the warm-up and are dropped.
+ *
+ * \param[in]    *pn_x                    - Input samples
+ * \param[out]   *pn_y                    - n_size - PPG_VALLEY_FILTER_DELAY outputs, pn_y[i]
+ *                                          belongs to pn_x[i .. i + PPG_VALLEY_FILTER_DELAY]
+ * \param[in]    n_size                   - Number of input samples
+ *
+ * \retval       None
+ */
+{
+    int32_t an_block[32];
+    PpgMa4_t s_ma4;
+    PpgDiff_t s_diff;
+    PpgMa2_t s_ma2;
+    PpgFir_t s_fir;
+    int32_t n_pos, n_len, k;
+
+    ppg_ma4_init(&s_ma4);
+    ppg_diff_init(&s_diff);
+    ppg_ma2_init(&s_ma2);
+    ppg_fir_init(&s_fir, aw_ppg_hamming_neg, 5, PPG_VALLEY_FILTER_SHIFT);
+
+    for (n_pos = 0; n_pos < n_size; n_pos += n_len) {
+        n_len = n_size - n_pos;
+        if (n_len > (int32_t)(sizeof(an_block) / sizeof(an_block[0])))
+            n_len = sizeof(an_block) / sizeof(an_block[0]);
+        ppg_ma4_process(&s_ma4, &pn_x[n_pos], an_block, n_len);
+        ppg_diff_process(&s_diff, an_block, an_block, n_len);
+        ppg_ma2_process(&s_ma2, an_block, an_block, n_len);
+        ppg_fir_process(&s_fir, an_block, an_block, n_len);
+        for (k = 0; k < n_len; k++) {
+            if (n_pos + k >= PPG_VALLEY_FILTER_DELAY)
+                pn_y[n_pos + k - PPG_VALLEY_FILTER_DELAY] = an_block[k];
+        }
+    }
+}
+
+// 归一化前的 Hamming 累加，e0 为最新的 MA2 输出
+#define PPG_HAMMING_ACC(e0, e1, e2, e3, e4) \
+    (37 * ((e0) + (e4)) + 246 * ((e1) + (e3)) + 458 * (e2))
+
+RAMFUNC_INLINE void ppg_valley_filter_body(const int32_t *pn_x, int32_t *pn_y, int32_t n_size)
+/**
+ * \brief        Fused valley filter (MA4 + diff + MA2 + Hamming, negated)
+ * \par          Details
+ *               One pass, 4x unrolled, the four MA2 outputs of each step are kept in registers
+ *               and reused by the next step. pn_y may equal pn_x (output index trails input).
+ *
+ * \param[in]    *pn_x                    - Input samples, DC removal is not required
+ * \param[out]   *pn_y                    - n_size - PPG_VALLEY_FILTER_DELAY outputs
+ * \param[in]    n_size                   - Number of input samples
+ *
+ * \retval       None
+ */
+{
+    const int32_t *p;
+    int32_t *q;
+    int32_t n, n_e1, n_e2, n_e3, n_e4, n_ea, n_eb, n_ec, n_ed;
+
+    if (n_size <= PPG_VALLEY_FILTER_DELAY)
+        return;
+
+    // e[n] = x[n] + x[n-1] - x[n-4] - x[n-5]，先取 e[5..8] 作为 Hamming 的历史
+    n_e4 = pn_x[5] + pn_x[4] - pn_x[1] - pn_x[0];
+    n_e3 = pn_x[6] + pn_x[5] - pn_x[2] - pn_x[1];
+    n_e2 = pn_x[7] + pn_x[6] - pn_x[3] - pn_x[2];
+    n_e1 = pn_x[8] + pn_x[7] - pn_x[4] - pn_x[3];
+
+    p = &pn_x[PPG_VALLEY_FILTER_DELAY];
+    q = pn_y;
+    for (n = PPG_VALLEY_FILTER_DELAY; n + 4 <= n_size; n += 4, p += 4, q += 4) {
+        n_ea = p[0] + p[-1] - p[-4] - p[-5];
+        n_eb = p[1] + p[0] - p[-3] - p[-4];
+        n_ec = p[2] + p[1] - p[-2] - p[-3];
+        n_ed = p[3] + p[2] - p[-1] - p[-2];
+        q[0] = -PPG_HAMMING_ACC(n_ea, n_e1, n_e2, n_e3, n_e4) >> PPG_VALLEY_FILTER_SHIFT;
+        q[1] = -PPG_HAMMING_ACC(n_eb, n_ea, n_e1, n_e2, n_e3) >> PPG_VALLEY_FILTER_SHIFT;
+        q[2] = -PPG_HAMMING_ACC(n_ec, n_eb, n_ea, n_e1, n_e2) >> PPG_VALLEY_FILTER_SHIFT;
+        q[3] = -PPG_HAMMING_ACC(n_ed, n_ec, n_eb, n_ea, n_e1) >> PPG_VALLEY_FILTER_SHIFT;
+        n_e4 = n_ea;
+        n_e3 = n_eb;
+        n_e2 = n_ec;
+        n_e1 = n_ed;
+    }
+    for (; n < n_size; n++, p++, q++) {
+        n_ea = p[0] + p[-1] - p[-4] - p[-5];
+        q[0] = -PPG_HAMMING_ACC(n_ea, n_e1, n_e2, n_e3, n_e4) >> PPG_VALLEY_FILTER_SHIFT;
+        n_e4 = n_e3;
+        n_e3 = n_e2;
+        n_e2 = n_e1;
+        n_e1 = n_ea;
+    }
+}
+
+void ppg_valley_filter_flash(const int32_t *pn_x, int32_t *pn_y, int32_t n_size)
+{
+    ppg_valley_filter_body(pn_x, pn_y, n_size);
+}
+
+#if PPG_VALLEY_FILTER_IN_RAM || RAMFUNC_BENCHMARK
+RAMFUNC void ppg_valley_filter_ram(const int32_t *pn_x, int32_t *pn_y, int32_t n_size)
+{
+    ppg_valley_filter_body(pn_x, pn_y, n_size);
+}
+#endif
+
+void ppg_valley_filter(const int32_t *pn_x, int32_t *pn_y, int32_t n_size)
+/**
+ * \brief        Valley filter entry, placement selected in ramfunc.h
+ *
+ * \retval       None
+ */
+{
+#if defined(PPG_DSP_REFERENCE)
+    ppg_valley_filter_ref(pn_x, pn_y, n_size);
+#elif PPG_VALLEY_FILTER_IN_RAM
+    ppg_valley_filter_ram(pn_x, pn_y, n_size);
+#else
+    ppg_valley_filter_flash(pn_x, pn_y, n_size);
+#endif
+}
+
+void ppg_valley_filter_legacy(const int32_t *pn_x, int32_t *pn_y, int32_t n_size)
+/**
+ * \brief        Original Maxim passes (mean removal, divides in every stage), benchmark only
+ * \par          Details
+ *               Produces n_size - 11 outputs with the original scaling (sum of taps 1146).
+ *
+ * \retval       None
+ */
+{
+    int32_t k, i, s, n_mean;
+
+    n_mean = 0;
+    for (k = 0; k < n_size; k++)
+        n_mean += pn_x[k];
+    n_mean = n_mean / n_size;
+
+    // 4 pt Moving Average
+    for (k = 0; k < n_size - 4; k++)
+        pn_y[k] = ((pn_x[k] - n_mean) + (pn_x[k + 1] - n_mean) + (pn_x[k + 2] - n_mean) +
+                   (pn_x[k + 3] - n_mean)) /
+                  (int32_t)4;
+    // difference
+    for (k = 0; k < n_size - 4 - 1; k++)
+        pn_y[k] = pn_y[k + 1] - pn_y[k];
+    // 2-pt Moving Average
+    for (k = 0; k < n_size - 4 - 2; k++)
+        pn_y[k] = (pn_y[k] + pn_y[k + 1]) / 2;
+    // hamming window, flipped
+    for (i = 0; i < n_size - 5 - 4 - 2; i++) {
+        s = 0;
+        for (k = i; k < i + 5; k++)
+            s -= pn_y[k] * an_legacy_hamm[k - i];
+        pn_y[i] = s / (int32_t)1146;
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file    ppg_dsp.h
+ * @brief   Block-processing filter kernels for the PPG preprocessing chain
+ * @version V1.0
+ * @date    2025-10-21
+ * @note    The valley filter of the Maxim engine is 4-point moving average -> first difference
+ *          -> 2-point average -> 5-tap Hamming FIR (negated so valleys become peaks).
+ *
+ *          Every stage is available as a stateful block kernel (arbitrary block size, in-place
+ *          allowed) so the chain can be fed incrementally. The stages are kept unnormalised and
+ *          the whole gain (4 * 2 * 1024) is removed by a single shift in the FIR.
+ *
+ *          ppg_valley_filter() is the fused Cortex-M3 kernel: MA4 + diff + MA2 collapse to
+ *          e[n] = x[n] + x[n-1] - x[n-4] - x[n-5], which has no DC gain, so the raw samples can
+ *          be fed without removing the mean first. Output is bit-exact with the reference chain.
+ *          Define PPG_DSP_REFERENCE to route ppg_valley_filter() through the separate stages.
+ *          The fused kernel exists as a flash and a SRAM copy, see ramfunc.h.
+ *
+ *          Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ */
+#ifndef PPG_DSP_H_
+#define PPG_DSP_H_
+
+#include <stdint.h>
+
+#include "ramfunc.h"
+
+#define PPG_FIR_MAX_TAPS 8
+#define PPG_HAMMING_SHIFT 10          // Hamming 系数和为 1024
+#define PPG_VALLEY_FILTER_SHIFT 13    // MA4 (x4) * MA2 (x2) * Hamming (x1024)
+#define PPG_VALLEY_FILTER_DELAY 9     // 3 (MA4) + 1 (diff) + 1 (MA2) + 4 (FIR)
+
+// 4 点滑动和（不除 4）
+typedef struct {
+    int32_t an_hist[3];
+} PpgMa4_t;
+
+// 一阶差分
+typedef struct {
+    int32_t n_prev;
+} PpgDiff_t;
+
+// 2 点滑动和（不除 2）
+typedef struct {
+    int32_t n_prev;
+} PpgMa2_t;
+
+// 通用 FIR，输出右移 uch_shift 位
+typedef struct {
+    const int16_t *pw_taps;
+    uint8_t uch_taps;
+    uint8_t uch_shift;
+    int32_t an_hist[PPG_FIR_MAX_TAPS - 1];
+} PpgFir_t;
+
+extern const int16_t aw_ppg_hamming_neg[5];  // -round(1024 * hamming(5) / sum)
+
+void ppg_ma4_init(PpgMa4_t *ps_st);
+void ppg_ma4_process(PpgMa4_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size);
+void ppg_diff_init(PpgDiff_t *ps_st);
+void ppg_diff_process(PpgDiff_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size);
+void ppg_ma2_init(PpgMa2_t *ps_st);
+void ppg_ma2_process(PpgMa2_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size);
+void ppg_fir_init(PpgFir_t *ps_st, const int16_t *pw_taps, uint8_t uch_taps, uint8_t uch_shift);
+void ppg_fir_process(PpgFir_t *ps_st, const int32_t *pn_in, int32_t *pn_out, int32_t n_size);
+
+void ppg_valley_filter(const int32_t *pn_x, int32_t *pn_y, int32_t n_size);
+void ppg_valley_filter_flash(const int32_t *pn_x, int32_t *pn_y, int32_t n_size);
+RAMFUNC_DECL void ppg_valley_filter_ram(const int32_t *pn_x, int32_t *pn_y, int32_t n_size);
+void ppg_valley_filter_ref(const int32_t *pn_x, int32_t *pn_y, int32_t n_size);
+void ppg_valley_filter_legacy(const int32_t *pn_x, int32_t *pn_y, int32_t n_size);
+
+#endif /* PPG_DSP_H_ */
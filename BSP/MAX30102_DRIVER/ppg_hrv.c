@@ -0,0 +1,182 @@
+/**
+ * @file    ppg_hrv.c
+ * @brief   Beat-to-beat (RR) interval ring with incremental RMSSD / SDNN
+ * @version V1.0
+ * @date    2025-10-22
+ */
+#include "ppg_hrv.h"
+
+#include "int_math.h"
+
+static PpgRrEntry_t as_ring[PPG_HRV_RING_SIZE];
+static uint16_t uw_head;   // 下一个写入位置
+static uint16_t uw_count;  // 有效条目数
+static uint32_t un_total;  // 累计写入的间期数，用作序号
+
+static uint32_t un_last_beat_ms;
+static bool b_last_beat_valid;
+static uint16_t uw_last_rr_ms;  // 上一个被接受的间期，0 表示没有可比较的间期
+
+// 增量统计：环内所有条目
+static uint32_t un_sum_rr;
+static uint64_t ul_sum_rr_sq;
+static uint32_t un_sum_diff_sq;
+static uint16_t uw_diff_count;
+
+void ppg_hrv_reset(void)
+/**
+ * \brief        Clear the ring and all statistics
+ *
+ * \retval       None
+ */
+{
+    uw_head = 0;
+    uw_count = 0;
+    un_total = 0;
+    un_sum_rr = 0;
+    ul_sum_rr_sq = 0;
+    un_sum_diff_sq = 0;
+    uw_diff_count = 0;
+    ppg_hrv_break();
+}
+
+void ppg_hrv_break(void)
+/**
+ * \brief        The beat stream is interrupted (finger off, gain change, lost samples), the
+ *               next beat starts a new sequence instead of forming an interval
+ *
+ * \retval       None
+ */
+{
+    b_last_beat_valid = false;
+    uw_last_rr_ms = 0;
+}
+
+static void ppg_hrv_push(uint32_t un_time_ms, uint16_t uw_rr_ms, bool b_contiguous)
+{
+    PpgRrEntry_t *ps_e = &as_ring[uw_head];
+    int32_t n_diff;
+
+    if (uw_count == PPG_HRV_RING_SIZE) {
+        // 覆盖最旧的条目，先把它的贡献从统计中减去
+        un_sum_rr -= ps_e->uw_rr_ms;
+        ul_sum_rr_sq -= (uint32_t)ps_e->uw_rr_ms * ps_e->uw_rr_ms;
+        if (ps_e->uch_contiguous) {
+            un_sum_diff_sq -= ps_e->un_diff_sq;
+            uw_diff_count--;
+        }
+    } else {
+        uw_count++;
+    }
+
+    ps_e->un_time_ms = un_time_ms;
+    ps_e->uw_rr_ms = uw_rr_ms;
+    ps_e->uch_contiguous = b_contiguous ? 1 : 0;
+    ps_e->un_diff_sq = 0;
+    un_sum_rr += uw_rr_ms;
+    ul_sum_rr_sq += (uint32_t)uw_rr_ms * uw_rr_ms;
+    if (b_contiguous) {
+        n_diff = (int32_t)uw_rr_ms - uw_last_rr_ms;
+        ps_e->un_diff_sq = (uint32_t)(n_diff * n_diff);
+        un_sum_diff_sq += ps_e->un_diff_sq;
+        uw_diff_count++;
+    }
+
+    uw_head = (uw_head + 1) % PPG_HRV_RING_SIZE;
+    un_total++;
+}
+
+void ppg_hrv_add_beat(uint32_t un_time_ms)
+/**
+ * \brief        Feed one beat time, in ascending order within a window
+ *
+ * \param[in]    un_time_ms               - Absolute time of the beat (system tick, ms)
+ *
+ * \retval       None
+ */
+{
+    uint32_t un_rr;
+
+    if (!b_last_beat_valid) {
+        un_last_beat_ms = un_time_ms;
+        b_last_beat_valid = true;
+        return;
+    }
+    // 重叠窗口重复报告的心跳，或者比上一个心跳还早
+    if ((int32_t)(un_time_ms - un_last_beat_ms) < PPG_HRV_RR_MIN_MS)
+        return;
+
+    un_rr = un_time_ms - un_last_beat_ms;
+    un_last_beat_ms = un_time_ms;
+    if (un_rr > PPG_HRV_RR_MAX_MS) {
+        uw_last_rr_ms = 0;  // 中间有漏检的心跳，下一个间期不与之前的相接
+        return;
+    }
+    if (uw_last_rr_ms != 0 &&
+        (un_rr * 100 > (uint32_t)uw_last_rr_ms * (100 + PPG_HRV_RR_MAX_JUMP_PCT) ||
+         un_rr * 100 < (uint32_t)uw_last_rr_ms * (100 - PPG_HRV_RR_MAX_JUMP_PCT))) {
+        uw_last_rr_ms = 0;
+        return;
+    }
+
+    ppg_hrv_push(un_time_ms, (uint16_t)un_rr, uw_last_rr_ms != 0);
+    uw_last_rr_ms = (uint16_t)un_rr;
+}
+
+uint16_t ppg_hrv_count(void)
+{
+    return uw_count;
+}
+
+uint32_t ppg_hrv_total(void)
+/**
+ * \brief        Number of intervals stored since the last reset, the entry at index i has
+ *               sequence number total - count + i
+ *
+ * \retval       Total number of stored intervals
+ */
+{
+    return un_total;
+}
+
+bool ppg_hrv_get(uint16_t uw_index, PpgRrEntry_t *ps_entry)
+/**
+ * \brief        Read one entry, index 0 is the oldest
+ *
+ * \retval       false if the index is out of range
+ */
+{
+    if (uw_index >= uw_count)
+        return false;
+    *ps_entry = as_ring[(uw_head + PPG_HRV_RING_SIZE - uw_count + uw_index) % PPG_HRV_RING_SIZE];
+    return true;
+}
+
+uint16_t ppg_hrv_rmssd(void)
+/**
+ * \brief        Root mean square of successive differences over the ring (ms)
+ *
+ * \retval       RMSSD, 0 if there are no successive intervals
+ */
+{
+    if (uw_diff_count == 0)
+        return 0;
+    return (uint16_t)isqrt64(un_sum_diff_sq / uw_diff_count);
+}
+
+uint16_t ppg_hrv_sdnn(void)
+/**
+ * \brief        Standard deviation of the intervals in the ring (ms)
+ *
+ * \retval       SDNN, 0 with fewer than 2 intervals
+ */
+{
+    uint64_t ul_n = uw_count;
+    uint64_t ul_var_n2;
+
+    if (uw_count < 2)
+        return 0;
+    // Var = (n * sum(x^2) - sum(x)^2) / n^2
+    ul_var_n2 = ul_n * ul_sum_rr_sq - (uint64_t)un_sum_rr * un_sum_rr;
+    return (uint16_t)isqrt64(ul_var_n2 / (ul_n * ul_n));
+}
@@ -0,0 +1,44 @@
+/**
+ * @file    ppg_hrv.h
+ * @brief   Beat-to-beat (RR) interval ring with incremental RMSSD / SDNN
+ * @version V1.0
+ * @date    2025-10-22
+ * @note    Beats arrive as absolute times (ms) from overlapping analysis windows, so the same
+ *          beat is reported several times. A beat closer than PPG_HRV_RR_MIN_MS to the last
+ *          accepted one is treated as a duplicate. Intervals outside the physiological range
+ *          or jumping more than PPG_HRV_RR_MAX_JUMP_PCT from the previous one (missed or extra
+ *          beat) are not stored, and no interval is formed across ppg_hrv_break().
+ *
+ *          The sums behind RMSSD and SDNN are updated when an entry is pushed and when it is
+ *          overwritten, so reading them costs one integer square root.
+ *
+ *          Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ */
+#ifndef PPG_HRV_H_
+#define PPG_HRV_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PPG_HRV_RING_SIZE 64        // 保存最近 64 个 RR 间期
+#define PPG_HRV_RR_MIN_MS 300       // 200 bpm
+#define PPG_HRV_RR_MAX_MS 1500      // 40 bpm
+#define PPG_HRV_RR_MAX_JUMP_PCT 30  // 相邻间期变化超过 30% 视为漏检/误检
+
+typedef struct {
+    uint32_t un_time_ms;     // 间期结束（后一个心跳）的时刻
+    uint16_t uw_rr_ms;       // RR 间期 (ms)
+    uint8_t uch_contiguous;  // 与前一个间期首尾相接（中间没有丢弃的心跳）
+    uint32_t un_diff_sq;     // 与前一个间期差值的平方，不相接时为 0
+} PpgRrEntry_t;
+
+void ppg_hrv_reset(void);
+void ppg_hrv_break(void);
+void ppg_hrv_add_beat(uint32_t un_time_ms);
+uint16_t ppg_hrv_count(void);
+bool ppg_hrv_get(uint16_t uw_index, PpgRrEntry_t *ps_entry);
+uint32_t ppg_hrv_total(void);
+uint16_t ppg_hrv_rmssd(void);
+uint16_t ppg_hrv_sdnn(void);
+
+#endif /* PPG_HRV_H_ */
@@ -0,0 +1,150 @@
+/**
+ * @file    ppg_quality.c
+ * @brief   Perfusion index and signal quality index for the PPG analysis window
+ * @version V1.0
+ * @date    2025-10-21
+ */
+#include "ppg_quality.h"
+
+#include "algorithm.h"
+
+typedef struct {
+    uint32_t un_sum;
+    uint32_t un_min;
+    uint32_t un_max;
+    uint16_t uw_clipped;
+} PpgBlockStats_t;
+
+static PpgBlockStats_t as_blocks[PPG_QUALITY_BLOCKS];  // 最近完成的块，环形
+static PpgBlockStats_t s_current;                      // 正在累计的块
+static uint16_t uw_current_count;
+static uint8_t uch_head;    // 下一个写入位置，块满时即最旧的块
+static uint8_t uch_blocks;  // 已完成的块数 (<= PPG_QUALITY_BLOCKS)
+
+static void ppg_quality_start_block(void)
+{
+    s_current.un_sum = 0;
+    s_current.un_min = 0xFFFFFFFF;
+    s_current.un_max = 0;
+    s_current.uw_clipped = 0;
+    uw_current_count = 0;
+}
+
+void ppg_quality_reset(void)
+/**
+ * \brief        Drop all block statistics, called whenever the sample stream is discontinuous
+ *
+ * \retval       None
+ */
+{
+    uch_head = 0;
+    uch_blocks = 0;
+    ppg_quality_start_block();
+}
+
+void ppg_quality_add_sample(uint32_t un_ir)
+/**
+ * \brief        Accumulate one IR sample, closes a block every PPG_QUALITY_BLOCK samples
+ *
+ * \retval       None
+ */
+{
+    s_current.un_sum += un_ir;
+    if (un_ir < s_current.un_min)
+        s_current.un_min = un_ir;
+    if (un_ir > s_current.un_max)
+        s_current.un_max = un_ir;
+    if (un_ir >= PPG_QUALITY_CLIP_LEVEL)
+        s_current.uw_clipped++;
+
+    if (++uw_current_count >= PPG_QUALITY_BLOCK) {
+        as_blocks[uch_head] = s_current;
+        uch_head = (uch_head + 1) % PPG_QUALITY_BLOCKS;
+        if (uch_blocks < PPG_QUALITY_BLOCKS)
+            uch_blocks++;
+        ppg_quality_start_block();
+    }
+}
+
+bool ppg_quality_evaluate(PpgQuality_t *ps_q)
+/**
+ * \brief        PI and pre-analysis SQI of the last PPG_QUALITY_BLOCKS complete blocks
+ *
+ * \param[out]   *ps_q                    - Quality of the window, regularity set to 100
+ *
+ * \retval       false if fewer than PPG_QUALITY_BLOCKS blocks have been collected
+ */
+{
+    int32_t an_p2p[PPG_QUALITY_BLOCKS];
+    const PpgBlockStats_t *ps_oldest, *ps_newest;
+    uint32_t un_sum = 0, un_clipped = 0, un_dc, un_ac, un_drift;
+    int32_t n_sqi, k;
+
+    if (uch_blocks < PPG_QUALITY_BLOCKS)
+        return false;
+
+    for (k = 0; k < PPG_QUALITY_BLOCKS; k++) {
+        un_sum += as_blocks[k].un_sum;
+        un_clipped += as_blocks[k].uw_clipped;
+        an_p2p[k] = (int32_t)(as_blocks[k].un_max - as_blocks[k].un_min);
+    }
+    un_dc = un_sum / (PPG_QUALITY_BLOCK * PPG_QUALITY_BLOCKS);
+
+    // 块峰峰值取中值作为 AC，单个块内的运动尖峰或基线台阶不影响结果
+    maxim_sort_ascend(an_p2p, PPG_QUALITY_BLOCKS);
+    un_ac = (uint32_t)an_p2p[PPG_QUALITY_BLOCKS / 2];
+
+    ps_q->pi = (un_dc > 0) ? (uint16_t)min(un_ac * 10000u / un_dc, 0xFFFFu) : 0;
+    ps_q->clip_permille =
+        (uint16_t)(un_clipped * 1000u / (PPG_QUALITY_BLOCK * PPG_QUALITY_BLOCKS));
+
+    // 基线漂移：最旧与最新块均值之差相对脉搏幅度
+    ps_oldest = &as_blocks[uch_head];
+    ps_newest = &as_blocks[(uch_head + PPG_QUALITY_BLOCKS - 1) % PPG_QUALITY_BLOCKS];
+    un_drift = (ps_newest->un_sum > ps_oldest->un_sum) ? ps_newest->un_sum - ps_oldest->un_sum
+                                                      : ps_oldest->un_sum - ps_newest->un_sum;
+    un_drift /= PPG_QUALITY_BLOCK;
+    ps_q->drift_pct = (un_ac > 0) ? (uint16_t)min(un_drift * 100u / un_ac, 0xFFFFu) : 0xFFFF;
+
+    ps_q->regularity = 100;
+    if (ps_q->pi < PPG_QUALITY_PI_MIN) {
+        ps_q->sqi = 0;
+        return true;
+    }
+    n_sqi = 100;
+    if (ps_q->pi < 3 * PPG_QUALITY_PI_MIN)
+        n_sqi -= (3 * PPG_QUALITY_PI_MIN - ps_q->pi) * 2;  // 弱灌注
+    n_sqi -= ps_q->clip_permille / 2;                     // 5% 削顶扣 25 分
+    if (ps_q->drift_pct > 100)
+        n_sqi -= min((ps_q->drift_pct - 100) / 5, 100);  // 漂移超过一个脉搏幅度后逐渐扣分
+    ps_q->sqi = (uint8_t)((n_sqi > 0) ? n_sqi : 0);
+    return true;
+}
+
+void ppg_quality_apply_beats(PpgQuality_t *ps_q, const int32_t *pn_locs, int32_t n_count)
+/**
+ * \brief        Scale the SQI by the regularity of the beat intervals found by the engine
+ * \par          Details
+ *               Regularity = 100 - 2 * (mean absolute deviation / mean interval, in %), so
+ *               a 10 % interval spread still scores 80. Fewer than 3 beats scores 50.
+ *
+ * \retval       None
+ */
+{
+    int32_t k, n_mean, n_dev, n_cv;
+
+    if (n_count < 3) {
+        ps_q->regularity = 50;
+    } else {
+        n_mean = (pn_locs[n_count - 1] - pn_locs[0]) / (n_count - 1);
+        n_dev = 0;
+        for (k = 1; k < n_count; k++) {
+            int32_t n_d = pn_locs[k] - pn_locs[k - 1] - n_mean;
+            n_dev += (n_d > 0) ? n_d : -n_d;
+        }
+        n_dev /= n_count - 1;
+        n_cv = (n_mean > 0) ? n_dev * 100 / n_mean : 100;
+        ps_q->regularity = (uint8_t)((n_cv >= 50) ? 0 : 100 - 2 * n_cv);
+    }
+    ps_q->sqi = (uint8_t)((uint32_t)ps_q->sqi * ps_q->regularity / 100);
+}
@@ -0,0 +1,41 @@
+/**
+ * @file    ppg_quality.h
+ * @brief   Perfusion index and signal quality index for the PPG analysis window
+ * @version V1.0
+ * @date    2025-10-21
+ * @note    Statistics are accumulated per block of PPG_QUALITY_BLOCK samples while the samples
+ *          are acquired (sum / min / max / clipping of IR), so evaluating a window only merges
+ *          PPG_QUALITY_BLOCKS block records instead of making another pass over the buffer.
+ *
+ *          PI  = median block peak-to-peak / DC, in 0.01 %.
+ *          SQI = 0..100 from PI, clipping ratio and baseline drift before the analysis, scaled
+ *                by the beat interval regularity once the engine has located the beats.
+ *
+ *          Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ */
+#ifndef PPG_QUALITY_H_
+#define PPG_QUALITY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PPG_QUALITY_BLOCK 100                     // 每块样本数，与分析步长一致
+#define PPG_QUALITY_BLOCKS 5                      // 一个分析窗口的块数 (500 样本)
+#define PPG_QUALITY_CLIP_LEVEL (0x3FFFF - 0x100)  // 接近 18 位满量程视为削顶
+#define PPG_QUALITY_PI_MIN 10                     // PI 低于 0.1% 视为没有脉搏
+#define PPG_QUALITY_SQI_MIN 30                    // 低于该 SQI 的窗口跳过分析
+
+typedef struct {
+    uint16_t pi;             // 灌注指数，单位 0.01%
+    uint8_t sqi;             // 信号质量 0~100
+    uint16_t clip_permille;  // 削顶样本比例 (‰)
+    uint16_t drift_pct;      // 首尾块均值差 / 脉搏幅度 (%)
+    uint8_t regularity;      // 心跳间期规律性 0~100，未评估时为 100
+} PpgQuality_t;
+
+void ppg_quality_reset(void);
+void ppg_quality_add_sample(uint32_t un_ir);
+bool ppg_quality_evaluate(PpgQuality_t *ps_q);
+void ppg_quality_apply_beats(PpgQuality_t *ps_q, const int32_t *pn_locs, int32_t n_count);
+
+#endif /* PPG_QUALITY_H_ */
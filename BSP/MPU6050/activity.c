@@ -0,0 +1,200 @@
+#include "activity.h"
+
+#include <string.h>
+
+#include "int_math.h"
+
+#define ACTIVITY_LSB_PER_G 16384        // 参考量程 ±2g
+#define ACTIVITY_INTENSITY_FULL_MG 800  // 标准差达到该值时强度为 100
+#define GOERTZEL_Q 14
+
+// 2cos(2*pi*f/50Hz) (Q14)，f = 1.0, 1.25, ... 3.5Hz
+static const int32_t an_goertzel_coef[ACTIVITY_BIN_COUNT] = {
+    32510, 32365, 32188, 31979, 31739, 31467, 31164, 30831, 30467, 30073, 29649,
+};
+#define ACTIVITY_BIN0_FREQ_X100 100
+#define ACTIVITY_BIN_STEP_X100 25
+
+static const char *const activity_names[ACTIVITY_COUNT] = {"Still", "Walk", "Run", "Other"};
+
+static int16_t aw_window[ACTIVITY_WINDOW];  // 幅值 (mg)，环形
+// 待评估窗口的快照（按时间顺序）。ready 置位期间只由 activity_update 读取，中断不再写入
+static int16_t aw_snapshot[ACTIVITY_WINDOW];
+static volatile bool b_ready;
+static uint16_t uw_head;
+static uint16_t uw_filled;
+static uint16_t uw_since_eval;
+static uint32_t un_decim_sum;
+static uint8_t uch_decim_count;
+static ActivityResult_t s_result;
+
+void activity_reset(void)
+{
+    memset(aw_window, 0, sizeof(aw_window));
+    uw_head = 0;
+    uw_filled = 0;
+    uw_since_eval = 0;
+    un_decim_sum = 0;
+    uch_decim_count = 0;
+    b_ready = false;
+    memset(&s_result, 0, sizeof(s_result));
+    s_result.e_class = ACTIVITY_STILL;
+}
+
+/**
+ * @brief 在去均值的窗口上运行所有 Goertzel 滤波器，返回主频 (0.01Hz)
+ *
+ * @param pn_x 去均值后的窗口，按时间顺序
+ * @param pl_power 主频能量
+ */
+static uint16_t activity_dominant(const int32_t *pn_x, int64_t *pl_power)
+{
+    int64_t al_power[ACTIVITY_BIN_COUNT];
+    uint8_t uch_best = 0;
+    int32_t n_freq;
+
+    for (uint8_t k = 0; k < ACTIVITY_BIN_COUNT; k++) {
+        int64_t l_s1 = 0, l_s2 = 0, l_s0;
+        for (uint16_t i = 0; i < ACTIVITY_WINDOW; i++) {
+            l_s0 = pn_x[i] + ((an_goertzel_coef[k] * l_s1) >> GOERTZEL_Q) - l_s2;
+            l_s2 = l_s1;
+            l_s1 = l_s0;
+        }
+        al_power[k] =
+            l_s1 * l_s1 + l_s2 * l_s2 - ((an_goertzel_coef[k] * l_s1) >> GOERTZEL_Q) * l_s2;
+        if (al_power[k] > al_power[uch_best])
+            uch_best = k;
+    }
+
+    // 相邻三个频点抛物线插值，细化到频点间隔以下
+    n_freq = ACTIVITY_BIN0_FREQ_X100 + uch_best * ACTIVITY_BIN_STEP_X100;
+    if (uch_best > 0 && uch_best < ACTIVITY_BIN_COUNT - 1) {
+        int64_t l_prev = al_power[uch_best - 1];
+        int64_t l_next = al_power[uch_best + 1];
+        int64_t l_den = 2 * (2 * al_power[uch_best] - l_prev - l_next);
+        if (l_den > 0)
+            n_freq += (int32_t)((l_next - l_prev) * ACTIVITY_BIN_STEP_X100 / l_den);
+    }
+    *pl_power = al_power[uch_best];
+    return (uint16_t)n_freq;
+}
+
+static void activity_evaluate(const int16_t *pw_window)
+{
+    int32_t an_x[ACTIVITY_WINDOW];
+    int32_t n_sum = 0, n_mean;
+    uint32_t un_var = 0;
+    uint16_t uw_crossings = 0;
+    uint16_t uw_freq, uw_std, uw_zcr, uw_tol;
+    int64_t l_power;
+    uint32_t un_periodic;
+    ActivityResult_t s_new;
+
+    for (uint16_t i = 0; i < ACTIVITY_WINDOW; i++)
+        n_sum += pw_window[i];
+    n_mean = n_sum / ACTIVITY_WINDOW;
+    for (uint16_t i = 0; i < ACTIVITY_WINDOW; i++) {
+        an_x[i] = pw_window[i] - n_mean;
+        un_var += (uint32_t)(an_x[i] * an_x[i]);
+        if (i > 0 && ((an_x[i] < 0) != (an_x[i - 1] < 0)))
+            uw_crossings++;
+    }
+    un_var /= ACTIVITY_WINDOW;
+    uw_std = (uint16_t)isqrt32(un_var);
+    // 每个周期两次过零
+    uw_zcr = (uint16_t)((uint32_t)uw_crossings * ACTIVITY_RATE_HZ * 100 / (2 * ACTIVITY_WINDOW));
+
+    memset(&s_new, 0, sizeof(s_new));
+    s_new.uw_std_mg = uw_std;
+    s_new.uw_zcr_x100 = uw_zcr;
+    s_new.uch_intensity = (uw_std >= ACTIVITY_INTENSITY_FULL_MG)
+                              ? 100
+                              : (uint8_t)(uw_std * 100 / ACTIVITY_INTENSITY_FULL_MG);
+
+    if (uw_std < ACTIVITY_STILL_STD_MG) {
+        s_new.e_class = ACTIVITY_STILL;
+        s_result = s_new;
+        return;
+    }
+
+    uw_freq = activity_dominant(an_x, &l_power);
+    // 纯正弦时 power = (N*A/2)^2，var = A^2/2，占比为 100%
+    un_periodic = (uint32_t)(l_power * 200 / ((int64_t)ACTIVITY_WINDOW * ACTIVITY_WINDOW * un_var));
+    s_new.uch_periodic = (un_periodic > 100) ? 100 : (uint8_t)un_periodic;
+    uw_tol = (uint16_t)((uint32_t)uw_freq * ACTIVITY_ZCR_TOL_PCT / 100);
+
+    if (s_new.uch_periodic >= ACTIVITY_PERIODIC_PCT && uw_zcr + uw_tol >= uw_freq &&
+        uw_zcr <= uw_freq + uw_tol) {
+        s_new.uw_cadence = (uint16_t)((uint32_t)uw_freq * 60 / 100);
+        if (uw_std >= ACTIVITY_RUN_STD_MG || uw_freq >= ACTIVITY_RUN_MIN_FREQ_X100)
+            s_new.e_class = ACTIVITY_RUN;
+        else
+            s_new.e_class = ACTIVITY_WALK;
+    } else {
+        s_new.e_class = ACTIVITY_OTHER;
+    }
+    s_result = s_new;
+}
+
+/**
+ * @brief 输入一帧加速度原始值（200Hz），可在中断中调用
+ *        只做抽取和入窗，每 ACTIVITY_HOP 个点把窗口复制为快照，评估留给 activity_update。
+ *        上一个快照尚未评估时跳过本次，不覆盖正在评估的数据
+ *
+ * @param w_ax X 轴加速度原始值
+ * @param w_ay Y 轴加速度原始值
+ * @param w_az Z 轴加速度原始值
+ * @return true 本帧产生了待评估的窗口
+ */
+bool activity_push(int16_t w_ax, int16_t w_ay, int16_t w_az)
+{
+    uint32_t un_mag;
+
+    un_mag = isqrt32(mag_sq3(w_ax, w_ay, w_az));
+    un_decim_sum += un_mag;
+    if (++uch_decim_count < ACTIVITY_DECIM)
+        return false;
+
+    aw_window[uw_head] = (int16_t)(un_decim_sum * 1000 / (ACTIVITY_DECIM * ACTIVITY_LSB_PER_G));
+    uw_head = (uw_head + 1) % ACTIVITY_WINDOW;
+    un_decim_sum = 0;
+    uch_decim_count = 0;
+    if (uw_filled < ACTIVITY_WINDOW)
+        uw_filled++;
+    if (++uw_since_eval < ACTIVITY_HOP || uw_filled < ACTIVITY_WINDOW)
+        return false;
+    uw_since_eval = 0;
+    if (b_ready)
+        return false;
+    memcpy(aw_snapshot, &aw_window[uw_head], (ACTIVITY_WINDOW - uw_head) * sizeof(int16_t));
+    memcpy(&aw_snapshot[ACTIVITY_WINDOW - uw_head], aw_window, uw_head * sizeof(int16_t));
+    b_ready = true;
+    return true;
+}
+
+/**
+ * @brief 评估 activity_push 准备好的窗口，在任务中调用
+ *
+ * @return true 产生了新的分类结果
+ */
+bool activity_update(void)
+{
+    if (!b_ready)
+        return false;
+    activity_evaluate(aw_snapshot);
+    b_ready = false;
+    return true;
+}
+
+/**
+ * @brief 最近一次的分类结果，窗口未满前为静止，与 activity_update 在同一上下文中调用
+ */
+void activity_get(ActivityResult_t *ps_result)
+{
+    *ps_result = s_result;
+}
+
+const char *activity_name(Activity_t e_class)
+{
+    return (e_class < ACTIVITY_COUNT) ? activity_names[e_class] : "?";
+}
@@ -0,0 +1,61 @@
+/**
+ * @file activity.h
+ * @author Shiki
+ * @brief Still / walk / run / other classification with cadence and intensity.
+ *        The acceleration magnitude is decimated to ACTIVITY_RATE_HZ and kept in a
+ *        2.56 s window that is evaluated every 1.28 s. Features are the variance, the
+ *        zero-crossing rate and the dominant step frequency found with Goertzel filters
+ *        at 0.25 Hz spacing over 1.0 - 3.5 Hz. The magnitude has one peak per step, so
+ *        the dominant frequency times 60 is the cadence.
+ *        activity_push only decimates and fills the window, so it is cheap enough for the
+ *        sampling interrupt; the evaluation runs in activity_update from a task.
+ *        Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ * @version 0.1
+ * @date 2025-10-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __ACTIVITY_H
+#define __ACTIVITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ACTIVITY_INPUT_HZ 200  // 输入帧率，即 MPU6050 参考帧率
+#define ACTIVITY_DECIM 4       // 每 4 帧取平均
+#define ACTIVITY_RATE_HZ (ACTIVITY_INPUT_HZ / ACTIVITY_DECIM)
+#define ACTIVITY_WINDOW 128    // 2.56s
+#define ACTIVITY_HOP 64        // 每 1.28s 评估一次
+#define ACTIVITY_BIN_COUNT 11  // 1.0 - 3.5Hz，间隔 0.25Hz
+
+#define ACTIVITY_STILL_STD_MG 25        // 标准差低于该值为静止
+#define ACTIVITY_RUN_STD_MG 450         // 周期运动且标准差高于该值为跑步
+#define ACTIVITY_RUN_MIN_FREQ_X100 250  // 或者步频高于 2.5Hz (150 步/分钟)
+#define ACTIVITY_PERIODIC_PCT 35        // 主频能量占比（相对纯正弦）低于该值为非周期运动
+#define ACTIVITY_ZCR_TOL_PCT 50         // 过零率与主频的允许偏差
+
+typedef enum {
+    ACTIVITY_STILL = 0,
+    ACTIVITY_WALK,
+    ACTIVITY_RUN,
+    ACTIVITY_OTHER,  // 有运动但没有稳定的步态周期（抬手、乘车等）
+    ACTIVITY_COUNT
+} Activity_t;
+
+typedef struct {
+    Activity_t e_class;
+    uint16_t uw_cadence;    // 步/分钟，非行走/跑步时为 0
+    uint8_t uch_intensity;  // 0-100，由加速度标准差换算
+    uint16_t uw_std_mg;     // 幅值标准差 (mg)
+    uint8_t uch_periodic;   // 主频能量占比 (%)，纯正弦约为 100
+    uint16_t uw_zcr_x100;   // 过零率换算的频率 (0.01Hz)
+} ActivityResult_t;
+
+void activity_reset(void);
+bool activity_push(int16_t w_ax, int16_t w_ay, int16_t w_az);
+bool activity_update(void);
+void activity_get(ActivityResult_t *ps_result);
+const char *activity_name(Activity_t e_class);
+
+#endif
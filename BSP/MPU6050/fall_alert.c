@@ -0,0 +1,121 @@
+#include "fall_alert.h"
+
+#include <string.h>
+
+#include "cycle_counter.h"
+#include "uart_user.h"
+
+static FallDetect_t fall_detector;
+static FallAlertStatus_t fall_status;
+static uint8_t alert_payload[FALL_ALERT_PAYLOAD_SIZE];
+static uint8_t alert_seq;
+
+// 采样配置改变（采集已停止）：按新的输出速率与量程重新换算阈值
+static void FallAlert_OnImuConfig(const MPU6050_Config_t *cfg) {
+    fall_status.enabled = cfg->odr_hz >= FALL_ALERT_MIN_RATE_HZ;
+    fall_detect_init(&fall_detector, cfg->odr_hz, MPU6050_GetAccelLsbPerG());
+}
+
+/**
+ * @brief 注册采样配置监听并按当前配置初始化，在 MPU6050_Init 之后调用
+ */
+void FallAlert_Init(void) {
+    MPU6050_AddConfigListener(FallAlert_OnImuConfig);
+    FallAlert_OnImuConfig(MPU6050_GetConfig());
+}
+
+/**
+ * @brief 运动唤醒后、恢复采集之前调用（采集停止，不与中断竞争）
+ *        唤醒的运动可能就是跌倒的失重阶段，检测器直接等待冲击；没有采到失重时还要求姿态改变
+ */
+void FallAlert_Resume(void) {
+    if (fall_status.enabled) {
+        fall_detect_resume(&fall_detector);
+    }
+}
+
+static void FallAlert_Send(void) {
+    if (BLE_SendAlert(BLE_ALERT_FALL, alert_payload, sizeof(alert_payload))) {
+        fall_status.pending = false;
+        fall_status.alerts_sent++;
+    } else {
+        fall_status.pending = true;
+        fall_status.retries++;
+    }
+}
+
+static void FallAlert_Raise(const FallInfo_t *info) {
+    uint32_t tick = HAL_GetTick();
+
+    fall_status.falls++;
+    fall_status.last = *info;
+    fall_status.last_tick = tick;
+    // 新告警覆盖仍未发出的旧告警，序号让接收端发现遗漏
+    alert_payload[0] = ++alert_seq;
+    alert_payload[1] = (uint8_t)tick;
+    alert_payload[2] = (uint8_t)(tick >> 8);
+    alert_payload[3] = (uint8_t)(tick >> 16);
+    alert_payload[4] = (uint8_t)(tick >> 24);
+    alert_payload[5] = (uint8_t)info->uw_freefall_ms;
+    alert_payload[6] = (uint8_t)(info->uw_freefall_ms >> 8);
+    alert_payload[7] = (uint8_t)info->uw_impact_mg;
+    alert_payload[8] = (uint8_t)(info->uw_impact_mg >> 8);
+    FallAlert_Send();
+}
+
+/**
+ * @brief 输入一批当前量程的原始帧（采集中断中调用，早于参考格式换算）
+ */
+void FallAlert_ProcessBatch(const MPU6050_Frame_t *frames, uint16_t n) {
+    FallInfo_t info;
+    bool fell = false;
+
+    if (fall_status.pending) {
+        FallAlert_Send();
+    }
+    if (!fall_status.enabled) {
+        return;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t start = CycleCounter_Get();
+        uint32_t cycles;
+        fell |= fall_detect_update(&fall_detector, frames[i].ax, frames[i].ay, frames[i].az,
+                                   &info);
+        cycles = CycleCounter_Get() - start;
+        if (cycles > fall_status.max_cycles) {
+            fall_status.max_cycles = cycles;
+        }
+        if (cycles > FALL_ALERT_CYCLE_BUDGET) {
+            fall_status.over_budget++;
+        }
+    }
+    // 一批只有 50ms，最多确认一次跌倒（确认需要 3s 以上）
+    if (fell) {
+        FallAlert_Raise(&info);
+    }
+}
+
+/**
+ * @brief 读取检测状态与统计（任务中调用）
+ */
+void FallAlert_GetStatus(FallAlertStatus_t *status) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *status = fall_status;
+    __set_PRIMASK(primask);
+}
+
+void FallAlert_ClearStats(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    fall_status.falls = 0;
+    fall_status.alerts_sent = 0;
+    fall_status.retries = 0;
+    fall_status.max_cycles = 0;
+    fall_status.over_budget = 0;
+    memset(&fall_status.last, 0, sizeof(fall_status.last));
+    fall_status.last_tick = 0;
+    __set_PRIMASK(primask);
+}
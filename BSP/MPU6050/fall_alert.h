@@ -0,0 +1,54 @@
+/**
+ * @file fall_alert.h
+ * @author Shiki
+ * @brief Runs the fall detector on every native IMU frame in the acquisition interrupt
+ *        and sends the BLE alert frame from the same context, without waiting for the
+ *        polled command task. If the previous alert is still queued the new one is retried
+ *        on every following batch until it is accepted. Detection needs at least
+ *        FALL_ALERT_MIN_RATE_HZ and follows MPU6050 configuration changes; the per-sample cost
+ *        is measured with the DWT counter and checked against FALL_ALERT_CYCLE_BUDGET.
+ *        While the IMU sleeps in wake-on-motion mode no frames arrive; a fall starts with a
+ *        1 g drop that trips the motion interrupt, and FallAlert_Resume() arms the detector
+ *        to catch the impact in the first frames after sampling restarts. Any motion can
+ *        wake the IMU, so without a sampled free fall the detector also requires the wrist
+ *        to come to rest in a new orientation (see fall_detect.h).
+ * @version 0.1
+ * @date 2025-10-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __FALL_ALERT_H
+#define __FALL_ALERT_H
+
+#include <stdbool.h>
+
+#include "fall_detect.h"
+#include "mpu6050.h"
+
+#define FALL_ALERT_MIN_RATE_HZ 100   // 低于该输出速率时失重阶段采样不足，停止检测
+#define FALL_ALERT_CYCLE_BUDGET 200  // 每个样本的周期预算（72MHz，1kHz 下约占 0.3% CPU）
+
+// 告警帧负载：序号(u8) + 时刻(u32) + 失重时间 ms(u16) + 冲击峰值 mg(u16)，小端
+// 失重发生在运动唤醒期间（未采样）时只含采到的部分，可能为 0
+#define FALL_ALERT_PAYLOAD_SIZE 9
+
+typedef struct {
+    bool enabled;          // 当前输出速率下检测是否运行
+    bool pending;          // 告警等待 UART 空闲
+    uint32_t falls;        // 检测到的跌倒次数
+    uint32_t alerts_sent;  // 已开始发送的告警帧
+    uint32_t retries;      // UART 忙导致的重试次数
+    uint32_t max_cycles;   // 单个样本的最大周期数
+    uint32_t over_budget;  // 超过周期预算的样本数
+    FallInfo_t last;       // 最近一次跌倒
+    uint32_t last_tick;
+} FallAlertStatus_t;
+
+void FallAlert_Init(void);
+void FallAlert_Resume(void);
+void FallAlert_ProcessBatch(const MPU6050_Frame_t *frames, uint16_t n);
+void FallAlert_GetStatus(FallAlertStatus_t *status);
+void FallAlert_ClearStats(void);
+
+#endif
@@ -0,0 +1,177 @@
+#include "fall_detect.h"
+
+#include <string.h>
+
+#include "int_math.h"
+
+#define MS_TO_SAMPLES(ms, hz) ((uint16_t)((uint32_t)(ms) * (hz) / 1000))
+
+// mg 换算为原始值后取平方
+static uint32_t fall_mg_sq(uint32_t un_mg, uint16_t uw_lsb_per_g)
+{
+    uint32_t un_lsb = un_mg * uw_lsb_per_g / 1000;
+    return un_lsb * un_lsb;
+}
+
+/**
+ * @brief 按采样率与量程换算阈值并清空状态，配置改变时重新调用
+ *
+ * @param ps_st 检测器
+ * @param uw_rate_hz 输入采样率
+ * @param uw_lsb_per_g 当前量程下 1g 对应的原始值
+ */
+void fall_detect_init(FallDetect_t *ps_st, uint16_t uw_rate_hz, uint16_t uw_lsb_per_g)
+{
+    uint32_t un_impact_mg = FALL_IMPACT_MG;
+    uint32_t un_fs_mg = 32767UL * 1000 / uw_lsb_per_g;
+
+    memset(ps_st, 0, sizeof(*ps_st));
+    // 量程不足时冲击会饱和，阈值降到量程的 95% 以内
+    if (un_impact_mg > un_fs_mg * 95 / 100)
+        un_impact_mg = un_fs_mg * 95 / 100;
+    ps_st->un_freefall_thr2 = fall_mg_sq(FALL_FREEFALL_MG, uw_lsb_per_g);
+    ps_st->un_impact_thr2 = fall_mg_sq(un_impact_mg, uw_lsb_per_g);
+    ps_st->un_still_lo2 = fall_mg_sq(1000 - FALL_STILL_TOL_MG, uw_lsb_per_g);
+    ps_st->un_still_hi2 = fall_mg_sq(1000 + FALL_STILL_TOL_MG, uw_lsb_per_g);
+    ps_st->uw_freefall_min = MS_TO_SAMPLES(FALL_FREEFALL_MIN_MS, uw_rate_hz);
+    ps_st->uw_impact_window = MS_TO_SAMPLES(FALL_IMPACT_WINDOW_MS, uw_rate_hz);
+    ps_st->uw_settle = MS_TO_SAMPLES(FALL_SETTLE_MS, uw_rate_hz);
+    ps_st->uw_inactive = MS_TO_SAMPLES(FALL_INACTIVE_MS, uw_rate_hz);
+    ps_st->uw_moving_max =
+        (uint16_t)((uint32_t)ps_st->uw_inactive * FALL_INACTIVE_MOVING_PCT / 100);
+    ps_st->uw_lsb_per_g = uw_lsb_per_g;
+    ps_st->uw_rate_hz = uw_rate_hz;
+    ps_st->e_state = FALL_STATE_IDLE;
+}
+
+/**
+ * @brief 运动唤醒后恢复采样时调用：失重可能发生在停止采样期间，从第一帧起直接等待冲击
+ *        仍在失重时照常计时并从失重结束起等待冲击；采到的失重不足最短时间时，
+ *        只有静止后的姿态与暂停前相差超过 FALL_RESUME_TILT_DEG 才确认
+ *
+ * @param ps_st 检测器（已按当前配置初始化，暂停前的帧已输入）
+ */
+void fall_detect_resume(FallDetect_t *ps_st)
+{
+    ps_st->e_state = FALL_STATE_IMPACT_WAIT;
+    ps_st->uw_count = 0;
+    ps_st->uw_freefall_len = 0;
+    ps_st->un_peak2 = 0;
+    ps_st->uch_resumed = 1;
+}
+
+// 当前帧与姿态参考的夹角是否超过 FALL_RESUME_TILT_DEG，每次确认只计算一次
+static bool fall_tilted(const FallDetect_t *ps_st, int16_t w_ax, int16_t w_ay, int16_t w_az)
+{
+    int64_t l_dot = (int64_t)w_ax * ps_st->aw_ref[0] + (int64_t)w_ay * ps_st->aw_ref[1] +
+                    (int64_t)w_az * ps_st->aw_ref[2];
+    int64_t l_ref2 = mag_sq3(ps_st->aw_ref[0], ps_st->aw_ref[1], ps_st->aw_ref[2]);
+    int64_t l_cur2 = mag_sq3(w_ax, w_ay, w_az);
+
+    // 没有参考姿态（初始化后未见过静止帧）时不确认
+    if (l_ref2 == 0)
+        return false;
+    if (l_dot <= 0)
+        return true;
+    // cos^2 = dot^2 / (|ref|^2 |cur|^2)，两边同除 2^16 避免溢出
+    return (l_dot >> 16) * (l_dot >> 16) * 100 <
+           FALL_RESUME_COS2_PCT * (l_ref2 >> 16) * (l_cur2 >> 16);
+}
+
+/**
+ * @brief 输入一帧加速度原始值
+ *
+ * @param ps_st 检测器
+ * @param w_ax X 轴加速度原始值（当前量程）
+ * @param w_ay Y 轴加速度原始值
+ * @param w_az Z 轴加速度原始值
+ * @param ps_info 检测到跌倒时输出失重时间与冲击峰值
+ * @return true 本帧确认了一次跌倒
+ */
+bool fall_detect_update(FallDetect_t *ps_st, int16_t w_ax, int16_t w_ay, int16_t w_az,
+                        FallInfo_t *ps_info)
+{
+    uint32_t un_mag2 = mag_sq3(w_ax, w_ay, w_az);
+
+    switch (ps_st->e_state) {
+        case FALL_STATE_IDLE:
+            ps_st->uch_resumed = 0;
+            if (un_mag2 >= ps_st->un_still_lo2 && un_mag2 <= ps_st->un_still_hi2) {
+                ps_st->aw_ref[0] = w_ax;
+                ps_st->aw_ref[1] = w_ay;
+                ps_st->aw_ref[2] = w_az;
+            }
+            if (un_mag2 >= ps_st->un_freefall_thr2) {
+                ps_st->uw_freefall_len = 0;
+            } else if (++ps_st->uw_freefall_len >= ps_st->uw_freefall_min) {
+                ps_st->e_state = FALL_STATE_FREEFALL;
+            }
+            break;
+        case FALL_STATE_FREEFALL:
+            if (un_mag2 < ps_st->un_freefall_thr2) {
+                if (ps_st->uw_freefall_len < UINT16_MAX)
+                    ps_st->uw_freefall_len++;
+                break;
+            }
+            ps_st->e_state = FALL_STATE_IMPACT_WAIT;
+            ps_st->uw_count = 0;
+            ps_st->un_peak2 = 0;
+            // 失重结束的这一帧可能就是冲击
+            // fall through
+        case FALL_STATE_IMPACT_WAIT:
+            // 唤醒时仍在失重：计入失重时间，冲击窗口从失重结束起算
+            if (ps_st->uch_resumed && un_mag2 < ps_st->un_freefall_thr2) {
+                if (ps_st->uw_freefall_len < UINT16_MAX)
+                    ps_st->uw_freefall_len++;
+                ps_st->uw_count = 0;
+                break;
+            }
+            if (un_mag2 > ps_st->un_peak2)
+                ps_st->un_peak2 = un_mag2;
+            if (un_mag2 > ps_st->un_impact_thr2) {
+                ps_st->e_state = FALL_STATE_SETTLE;
+                ps_st->uw_count = 0;
+            } else if (++ps_st->uw_count >= ps_st->uw_impact_window) {
+                ps_st->e_state = FALL_STATE_IDLE;  // 失重后没有冲击，例如抛起后接住
+                ps_st->uw_freefall_len = 0;
+            }
+            break;
+        case FALL_STATE_SETTLE:
+            if (un_mag2 > ps_st->un_peak2)
+                ps_st->un_peak2 = un_mag2;
+            if (++ps_st->uw_count >= ps_st->uw_settle) {
+                ps_st->e_state = FALL_STATE_INACTIVE;
+                ps_st->uw_count = 0;
+                ps_st->uw_moving = 0;
+            }
+            break;
+        case FALL_STATE_INACTIVE:
+            if ((un_mag2 < ps_st->un_still_lo2 || un_mag2 > ps_st->un_still_hi2) &&
+                ++ps_st->uw_moving > ps_st->uw_moving_max) {
+                ps_st->e_state = FALL_STATE_IDLE;  // 冲击后仍在活动，不是跌倒
+                ps_st->uw_freefall_len = 0;
+                break;
+            }
+            if (++ps_st->uw_count < ps_st->uw_inactive)
+                break;
+            // 唤醒后没有采到足够的失重：唤醒的运动不能作为证据，还要求姿态改变（躺倒）
+            if (ps_st->uch_resumed && ps_st->uw_freefall_len < ps_st->uw_freefall_min &&
+                !fall_tilted(ps_st, w_ax, w_ay, w_az)) {
+                ps_st->e_state = FALL_STATE_IDLE;
+                ps_st->uw_freefall_len = 0;
+                break;
+            }
+            ps_info->uw_freefall_ms =
+                (uint16_t)((uint32_t)ps_st->uw_freefall_len * 1000 / ps_st->uw_rate_hz);
+            ps_info->uw_impact_mg =
+                (uint16_t)(isqrt32(ps_st->un_peak2) * 1000 / ps_st->uw_lsb_per_g);
+            ps_st->e_state = FALL_STATE_IDLE;
+            ps_st->uw_freefall_len = 0;
+            ps_st->uw_count = 0;
+            return true;
+        default:
+            ps_st->e_state = FALL_STATE_IDLE;
+            break;
+    }
+    return false;
+}
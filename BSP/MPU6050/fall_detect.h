@@ -0,0 +1,83 @@
+/**
+ * @file fall_detect.h
+ * @author Shiki
+ * @brief Fall detection on the native-range acceleration stream (100 - 1000 Hz).
+ *        A fall is free fall (magnitude well below 1 g for a minimum time), followed
+ *        within a short window by an impact (magnitude above FALL_IMPACT_MG), followed
+ *        after the bounce has settled by inactivity (magnitude staying near 1 g).
+ *        All thresholds are compared on the squared magnitude in raw LSB, precomputed
+ *        for the configured rate and range, so a sample costs a few multiply / compare
+ *        operations with no loop and no division. The only loop is the integer square
+ *        root run once per detected fall to report the impact peak.
+ *        When sampling resumes after a low-power pause that was ended by motion, the free
+ *        fall may already have happened unsampled: fall_detect_resume() then waits directly
+ *        for the impact. Without a sampled free fall the motion that woke the IMU is no
+ *        evidence by itself, so such a fall is only confirmed if the resting orientation
+ *        afterwards differs from the last one seen before the pause by more than
+ *        FALL_RESUME_TILT_DEG (lying down after a fall, not sitting down hard).
+ *        Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ * @version 0.1
+ * @date 2025-10-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __FALL_DETECT_H
+#define __FALL_DETECT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FALL_FREEFALL_MG 500         // 幅值低于该值视为失重
+#define FALL_FREEFALL_MIN_MS 60      // 失重至少持续该时间（约 2cm 落差以上）
+#define FALL_IMPACT_MG 2500          // 冲击阈值，超过量程的 95% 时按量程的 95% 判定
+#define FALL_IMPACT_WINDOW_MS 500    // 失重结束后在该时间内出现冲击
+#define FALL_SETTLE_MS 1000          // 冲击后忽略反弹的时间
+#define FALL_INACTIVE_MS 2000        // 随后静止检查的时长
+#define FALL_STILL_TOL_MG 200        // 静止检查中幅值与 1g 的允许偏差
+#define FALL_INACTIVE_MOVING_PCT 10  // 静止检查中超出偏差的样本比例上限
+#define FALL_RESUME_TILT_DEG 45      // 唤醒后未采到失重时，姿态至少改变该角度才确认
+#define FALL_RESUME_COS2_PCT 50      // cos^2(FALL_RESUME_TILT_DEG) (%)，修改角度时同步修改
+
+typedef enum {
+    FALL_STATE_IDLE = 0,
+    FALL_STATE_FREEFALL,
+    FALL_STATE_IMPACT_WAIT,
+    FALL_STATE_SETTLE,
+    FALL_STATE_INACTIVE
+} FallState_t;
+
+typedef struct {
+    // 由 fall_detect_init 按采样率与量程换算
+    uint32_t un_freefall_thr2;   // 失重阈值的平方 (LSB^2)
+    uint32_t un_impact_thr2;     // 冲击阈值的平方
+    uint32_t un_still_lo2;       // 静止带下限的平方
+    uint32_t un_still_hi2;       // 静止带上限的平方
+    uint16_t uw_freefall_min;    // 样本数
+    uint16_t uw_impact_window;   // 样本数
+    uint16_t uw_settle;          // 样本数
+    uint16_t uw_inactive;        // 样本数
+    uint16_t uw_moving_max;      // 静止检查中允许超出偏差的样本数
+    uint16_t uw_lsb_per_g;
+    uint16_t uw_rate_hz;
+    // 运行状态
+    FallState_t e_state;
+    uint16_t uw_count;           // 当前阶段的样本数
+    uint16_t uw_freefall_len;    // 失重持续的样本数
+    uint16_t uw_moving;          // 静止检查中超出偏差的样本数
+    uint32_t un_peak2;           // 冲击峰值的平方
+    uint8_t uch_resumed;         // 由 fall_detect_resume 进入，失重可能未采到
+    int16_t aw_ref[3];           // 空闲时最近一帧静止带内的加速度（姿态参考）
+} FallDetect_t;
+
+typedef struct {
+    uint16_t uw_freefall_ms;  // 失重持续时间（唤醒后确认时只含采到的部分，可能为 0）
+    uint16_t uw_impact_mg;    // 冲击峰值（受量程限制）
+} FallInfo_t;
+
+void fall_detect_init(FallDetect_t *ps_st, uint16_t uw_rate_hz, uint16_t uw_lsb_per_g);
+void fall_detect_resume(FallDetect_t *ps_st);
+bool fall_detect_update(FallDetect_t *ps_st, int16_t w_ax, int16_t w_ay, int16_t w_az,
+                        FallInfo_t *ps_info);
+
+#endif
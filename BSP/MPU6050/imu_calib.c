@@ -0,0 +1,215 @@
+#include "imu_calib.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rtc.h"
+#include "step_count.h"
+
+#define IMU_CALIB_BKP_FLAG RTC_BKP_DR5  // IMU_CALIB_BKP_MAGIC | 加速度已校准 (bit0)
+
+typedef enum {
+    IMU_CALIB_IDLE = 0,
+    IMU_CALIB_COLLECTING,  // 计步中断中累加帧
+    IMU_CALIB_READY        // 采集完成，等待任务计算并写入
+} ImuCalibPhase_t;
+
+static ImuCalibState_t calib_state;
+static volatile ImuCalibPhase_t calib_phase = IMU_CALIB_IDLE;
+static bool calib_requested = false;
+
+// 采集统计，以第一帧为参考点累加，平方和不会溢出
+static MPU6050_Frame_t calib_ref;
+static int32_t calib_sum[6];
+static uint64_t calib_sq[6];
+static uint16_t calib_count;
+
+static const uint32_t bkp_accel_regs[3] = {RTC_BKP_DR6, RTC_BKP_DR7, RTC_BKP_DR8};
+static const uint32_t bkp_gyro_regs[3] = {RTC_BKP_DR9, RTC_BKP_DR10, RTC_BKP_DR11};
+
+static void ImuCalib_Save(void) {
+    for (uint8_t i = 0; i < 3; i++) {
+        HAL_RTCEx_BKUPWrite(&hrtc, bkp_accel_regs[i], (uint16_t)calib_state.accel[i]);
+        HAL_RTCEx_BKUPWrite(&hrtc, bkp_gyro_regs[i], (uint16_t)calib_state.gyro[i]);
+    }
+    // 最后写标志，掉电发生在中途时不会恢复半组数据
+    HAL_RTCEx_BKUPWrite(&hrtc, IMU_CALIB_BKP_FLAG,
+                        IMU_CALIB_BKP_MAGIC | (calib_state.accel_calibrated ? 1 : 0));
+}
+
+// 采样配置改变，正在采集的统计跨越了配置切换，放弃后在下次静止时重新开始
+static void ImuCalib_OnImuConfig(const MPU6050_Config_t *cfg) {
+    if (calib_phase == IMU_CALIB_COLLECTING) {
+        calib_phase = IMU_CALIB_IDLE;
+    }
+}
+
+/**
+ * @brief 上电时从备份寄存器恢复偏移并写入 MPU6050，在 MPU6050_Init 之后、开始采集之前调用
+ */
+void ImuCalib_Init(void) {
+    uint32_t flag;
+
+    __HAL_RCC_BKP_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    memset(&calib_state, 0, sizeof(calib_state));
+    MPU6050_AddConfigListener(ImuCalib_OnImuConfig);
+    flag = HAL_RTCEx_BKUPRead(&hrtc, IMU_CALIB_BKP_FLAG);
+    if ((flag & ~1UL) != IMU_CALIB_BKP_MAGIC) {
+        MPU6050_ReadOffsets(calib_state.accel, calib_state.gyro);  // 出厂值
+        return;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        calib_state.accel[i] = (int16_t)HAL_RTCEx_BKUPRead(&hrtc, bkp_accel_regs[i]);
+        calib_state.gyro[i] = (int16_t)HAL_RTCEx_BKUPRead(&hrtc, bkp_gyro_regs[i]);
+    }
+    if (MPU6050_WriteOffsets(calib_state.accel, calib_state.gyro) == HAL_OK) {
+        calib_state.valid = true;
+        calib_state.accel_calibrated = (flag & 1) != 0;
+    }
+}
+
+/**
+ * @brief 输入一批帧（计步中断中调用），只在采集阶段累加
+ */
+void ImuCalib_Feed(const MPU6050_Frame_t *frames, uint16_t n) {
+    if (calib_phase != IMU_CALIB_COLLECTING) {
+        return;
+    }
+    for (uint16_t i = 0; i < n && calib_count < IMU_CALIB_FRAMES; i++) {
+        const int16_t *v = &frames[i].ax;
+        const int16_t *r = &calib_ref.ax;
+        if (calib_count == 0) {
+            calib_ref = frames[i];
+        }
+        for (uint8_t k = 0; k < 6; k++) {
+            int32_t d = (int32_t)v[k] - r[k];
+            calib_sum[k] += d;
+            calib_sq[k] += (uint64_t)((int64_t)d * d);
+        }
+        calib_count++;
+    }
+    if (calib_count >= IMU_CALIB_FRAMES) {
+        calib_phase = IMU_CALIB_READY;
+    }
+}
+
+/**
+ * @brief 请求尽快校准（下一次检测到静止时开始）
+ */
+void ImuCalib_Request(void) {
+    calib_requested = true;
+}
+
+/**
+ * @brief 正在采集或等待写入，此期间不应让 IMU 进入运动唤醒模式
+ */
+bool ImuCalib_IsBusy(void) {
+    return calib_phase != IMU_CALIB_IDLE;
+}
+
+const ImuCalibState_t *ImuCalib_GetState(void) {
+    return &calib_state;
+}
+
+static void ImuCalib_Start(void) {
+    memset(calib_sum, 0, sizeof(calib_sum));
+    memset(calib_sq, 0, sizeof(calib_sq));
+    calib_count = 0;
+    calib_phase = IMU_CALIB_COLLECTING;
+}
+
+// 保留 bit0（温度补偿位）的前提下修正加速度偏移寄存器
+static int16_t ImuCalib_AdjustAccel(int16_t reg, int32_t bias_raw) {
+    int32_t delta = bias_raw * MPU6050_ACCEL_OFFSET_LSB_PER_G / MPU6050_ACCEL_LSB_PER_G;
+    return (int16_t)(((reg - delta) & ~1L) | (reg & 1));
+}
+
+/**
+ * @brief 由采集结果计算偏移并写入，数据不满足静止条件时放弃
+ *
+ * @return true 已写入新的偏移
+ */
+static bool ImuCalib_Apply(void) {
+    const int16_t *r = &calib_ref.ax;
+    int32_t mean[6];
+    int16_t accel[3], gyro[3];
+    bool flat;
+    HAL_StatusTypeDef res;
+
+    for (uint8_t k = 0; k < 6; k++) {
+        int32_t m = calib_sum[k] / IMU_CALIB_FRAMES;  // 相对参考帧的均值
+        uint64_t var = calib_sq[k] / IMU_CALIB_FRAMES - (uint64_t)((int64_t)m * m);
+        uint32_t std_max = (k < 3) ? IMU_CALIB_ACCEL_STD_MAX : IMU_CALIB_GYRO_STD_MAX;
+        if (var > (uint64_t)std_max * std_max) {
+            return false;
+        }
+        mean[k] = r[k] + m;
+    }
+    for (uint8_t k = 3; k < 6; k++) {
+        if (mean[k] > IMU_CALIB_GYRO_BIAS_MAX || mean[k] < -IMU_CALIB_GYRO_BIAS_MAX) {
+            return false;
+        }
+    }
+    flat = labs(MPU6050_ACCEL_TO_MG(mean[0])) <= IMU_CALIB_FLAT_TOL_MG &&
+           labs(MPU6050_ACCEL_TO_MG(mean[1])) <= IMU_CALIB_FLAT_TOL_MG &&
+           labs(MPU6050_ACCEL_TO_MG(mean[2]) - 1000) <= IMU_CALIB_FLAT_TOL_MG;
+
+    // 写偏移寄存器需要独占 I2C，暂停采集；读回当前值后在其基础上修正
+    StepCount_Pause();
+    res = MPU6050_ReadOffsets(accel, gyro);
+    if (res == HAL_OK) {
+        for (uint8_t i = 0; i < 3; i++) {
+            gyro[i] -= (int16_t)(mean[3 + i] * MPU6050_GYRO_OFFSET_LSB_PER_10DPS /
+                                 (MPU6050_GYRO_LSB_PER_DPS * 10));
+        }
+        if (flat) {
+            accel[0] = ImuCalib_AdjustAccel(accel[0], mean[0]);
+            accel[1] = ImuCalib_AdjustAccel(accel[1], mean[1]);
+            accel[2] = ImuCalib_AdjustAccel(accel[2], mean[2] - MPU6050_ACCEL_LSB_PER_G);
+        }
+        res = MPU6050_WriteOffsets(accel, gyro);
+    }
+    StepCount_Resume();
+    if (res != HAL_OK) {
+        return false;
+    }
+
+    memcpy(calib_state.accel, accel, sizeof(accel));
+    memcpy(calib_state.gyro, gyro, sizeof(gyro));
+    calib_state.valid = true;
+    calib_state.accel_calibrated |= flat;
+    calib_state.tick = HAL_GetTick();
+    ImuCalib_Save();
+    return true;
+}
+
+/**
+ * @brief 校准任务：静止且到期（或有请求）时开始采集，采集完成后计算并写入
+ */
+void Task_ImuCalib(void) {
+    ActivityResult_t activity;
+    bool due;
+
+    if (calib_phase == IMU_CALIB_READY) {
+        if (ImuCalib_Apply()) {
+            calib_requested = false;
+        }
+        calib_phase = IMU_CALIB_IDLE;
+        return;
+    }
+
+    StepCount_GetActivity(&activity);
+    if (calib_phase == IMU_CALIB_COLLECTING) {
+        if (activity.e_class != ACTIVITY_STILL || StepCount_IsIdle()) {
+            calib_phase = IMU_CALIB_IDLE;  // 采集期间开始运动，放弃
+        }
+        return;
+    }
+
+    due = calib_requested || calib_state.tick == 0 ||
+          HAL_GetTick() - calib_state.tick >= IMU_CALIB_INTERVAL_MS;
+    if (due && activity.e_class == ACTIVITY_STILL && !StepCount_IsIdle()) {
+        ImuCalib_Start();
+    }
+}
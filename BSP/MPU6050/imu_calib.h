@@ -0,0 +1,49 @@
+/**
+ * @file imu_calib.h
+ * @author Shiki
+ * @brief MPU6050 accel / gyro bias calibration during detected stillness.
+ *        Frames are collected while the activity classifier reports still. If they really
+ *        are still, the gyro mean is the gyro bias; the accel bias is only estimated when
+ *        the device lies flat (Z up), where the expected reading is known. The corrections
+ *        are written into the MPU6050 offset registers, so every consumer gets corrected
+ *        data, and kept in RTC backup registers to be restored after reset.
+ * @version 0.1
+ * @date 2025-10-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __IMU_CALIB_H
+#define __IMU_CALIB_H
+
+#include <stdbool.h>
+
+#include "mpu6050.h"
+
+#define IMU_CALIB_FRAMES 400          // 采集 2s (200Hz)
+#define IMU_CALIB_INTERVAL_MS (30UL * 60 * 1000)  // 陀螺仪零偏随温度变化，静止时定期重新校准
+#define IMU_CALIB_TASK_PERIOD_MS 500
+#define IMU_CALIB_GYRO_STD_MAX 30     // 采集期间角速度标准差上限 (LSB)，超过视为未静止
+#define IMU_CALIB_ACCEL_STD_MAX 100   // 采集期间加速度标准差上限 (LSB)
+#define IMU_CALIB_GYRO_BIAS_MAX 2620  // 零偏上限 (20°/s)，超过视为在匀速转动
+#define IMU_CALIB_FLAT_TOL_MG 80      // 水平放置判定：X/Y 接近 0g、Z 接近 +1g 的容差
+
+// 备份寄存器 DR5 - DR11（DR1 - DR4 由 RTC 日期使用），bit0 为 0 以便携带标志位
+#define IMU_CALIB_BKP_MAGIC 0xCA10
+
+typedef struct {
+    int16_t accel[3];       // 当前写入的加速度偏移寄存器值
+    int16_t gyro[3];        // 当前写入的陀螺仪偏移寄存器值
+    bool valid;             // 已校准（本次运行或从备份寄存器恢复）
+    bool accel_calibrated;  // 加速度偏移是否经过水平放置校准
+    uint32_t tick;          // 本次运行中最近一次校准的时刻，0 表示尚未校准
+} ImuCalibState_t;
+
+void ImuCalib_Init(void);
+void ImuCalib_Feed(const MPU6050_Frame_t *frames, uint16_t n);
+void ImuCalib_Request(void);
+bool ImuCalib_IsBusy(void);
+const ImuCalibState_t *ImuCalib_GetState(void);
+void Task_ImuCalib(void);
+
+#endif
@@ -0,0 +1,59 @@
+#include "motion_energy.h"
+
+#define ACCEL_LSB_PER_G 16384  // 参考量程 ±2g
+#define MOTION_GATE_THRESHOLD \
+    ((uint32_t)MOTION_GATE_THRESHOLD_MG * ACCEL_LSB_PER_G / 1000 * MOTION_WINDOW_TICKS)
+
+static uint16_t energy_ring[MOTION_WINDOW_TICKS];  // 每槽的加速度变化量（L1，原始 LSB）
+static uint8_t ring_index = 0;
+static volatile uint32_t window_energy = 0;  // energy_ring 之和，滑动更新
+static int16_t last_ax, last_ay, last_az;
+static bool has_last = false;
+
+static uint16_t abs_diff(int16_t a, int16_t b) {
+    int32_t d = (int32_t)a - b;
+    return (uint16_t)((d < 0) ? -d : d);
+}
+
+/**
+ * @brief 每个统计槽调用一次（计步定时器中断中），传入该槽的平均加速度原始值
+ *
+ * @param ax X 轴加速度原始值
+ * @param ay Y 轴加速度原始值
+ * @param az Z 轴加速度原始值
+ */
+void MotionEnergy_Update(int16_t ax, int16_t ay, int16_t az) {
+    uint32_t e = 0;
+    if (has_last) {
+        // 相邻两槽的 L1 变化量，与重力方向无关
+        e = (uint32_t)abs_diff(ax, last_ax) + abs_diff(ay, last_ay) + abs_diff(az, last_az);
+        if (e > 0xFFFF) {
+            e = 0xFFFF;
+        }
+    }
+    last_ax = ax;
+    last_ay = ay;
+    last_az = az;
+    has_last = true;
+
+    window_energy = window_energy - energy_ring[ring_index] + e;
+    energy_ring[ring_index] = (uint16_t)e;
+    ring_index++;
+    if (ring_index >= MOTION_WINDOW_TICKS) {
+        ring_index = 0;
+    }
+}
+
+/**
+ * @brief 最近 MOTION_WINDOW_MS 内的运动能量（原始 LSB 累加）
+ */
+uint32_t MotionEnergy_GetWindow(void) {
+    return window_energy;
+}
+
+/**
+ * @brief 窗口内运动能量是否超过门限
+ */
+bool MotionEnergy_IsMoving(void) {
+    return window_energy > MOTION_GATE_THRESHOLD;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file motion_energy.h
+ * @author Shiki
+ * @brief Accelerometer motion energy over the same 5 s window as the PPG buffer.
+ *        Used to gate the heart rate analysis while the arm is moving.
+ * @version 0.1
+ * @date 2025-10-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __MOTION_ENERGY_H
+#define __MOTION_ENERGY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MOTION_TICK_MS 50                                 // 每个统计槽的时长，与计步定时器周期一致
+#define MOTION_WINDOW_MS 5000                             // 统计窗口，与 PPG 缓冲区时长一致
+#define MOTION_WINDOW_TICKS (MOTION_WINDOW_MS / MOTION_TICK_MS)
+#define MOTION_GATE_THRESHOLD_MG 50                       // 窗口内平均每槽加速度变化超过该值视为运动
+
+void MotionEnergy_Update(int16_t ax, int16_t ay, int16_t az);
+uint32_t MotionEnergy_GetWindow(void);
+bool MotionEnergy_IsMoving(void);
+
+#endif
@@ -1,15 +1,6 @@
 #include "mpu6050.h"
 
-
-// 原始数据
-int16_t Accel_X_RAW, Accel_Y_RAW, Accel_Z_RAW;
-int16_t Gyro_X_RAW, Gyro_Y_RAW, Gyro_Z_RAW;
-int16_t Temp_RAW;
-
-// 转换后的物理量
-float g_ax, g_ay, g_az;  // 加速度，单位g
-float g_gx, g_gy, g_gz;  // 角速度，单位°/s
-float g_temp;            // 温度，单位°C
+#include "sensor_hub.h"
 
 // 使用的I2C句柄
 #define MPU6050_HI2C hi2c2
@@ -18,10 +9,91 @@ float g_temp;            // 温度，单位°C
 #define MPU6050_ADDR (0x68 << 1)  // 若AD0接地，7位地址0x68，左移1位得到8位地址0xD0
 #define WHO_AM_I_REG 0x75         // WHO_AM_I寄存器地址，默认值0x68
 #define PWR_MGMT_1_REG 0x6B       // 电源管理寄存器1
+#define PWR_MGMT_2_REG 0x6C       // 电源管理寄存器2（低功耗唤醒频率、各轴待机）
+#define MOT_THR_REG 0x1F          // 运动检测阈值
+#define MOT_DUR_REG 0x20          // 运动检测持续时间
+#define XA_OFFS_H_REG 0x06        // 加速度偏移 X/Y/Z，各 2 字节（见偏移寄存器应用笔记）
+#define XG_OFFS_USRH_REG 0x13     // 陀螺仪偏移 X/Y/Z，各 2 字节
 #define SMPLRT_DIV_REG 0x19       // 采样率分频寄存器
 #define CONFIG_REG 0x1A           // 配置寄存器（含DLPF设置）
 #define GYRO_CONFIG_REG 0x1B      // 陀螺仪配置寄存器
 #define ACCEL_CONFIG_REG 0x1C     // 加速度计配置寄存器
+#define FIFO_EN_REG 0x23          // FIFO 数据选择寄存器
+#define USER_CTRL_REG 0x6A        // 用户控制寄存器（FIFO 使能/复位）
+#define FIFO_COUNTH_REG 0x72      // FIFO 字节数高字节，随后为低字节
+#define FIFO_R_W_REG 0x74         // FIFO 读写端口
+#define INT_PIN_CFG_REG 0x37      // INT 引脚配置寄存器
+#define INT_ENABLE_REG 0x38       // 中断使能寄存器
+#define INT_STATUS_REG 0x3A       // 中断状态寄存器，读取后清零
+#define ACCEL_XOUT_H_REG 0x3B     // 数据寄存器起始地址
+
+#define FIFO_EN_GYRO_ACCEL 0x78    // XG_FIFO_EN | YG_FIFO_EN | ZG_FIFO_EN | ACCEL_FIFO_EN
+#define USER_CTRL_FIFO_EN 0x40     // USER_CTRL[6]
+#define USER_CTRL_FIFO_RESET 0x04  // USER_CTRL[2]，复位后自动清零
+#define INT_ENABLE_DATA_RDY 0x01   // INT_ENABLE[0]
+#define INT_ENABLE_MOT 0x40        // INT_ENABLE[6]
+#define INT_STATUS_MOT 0x40        // INT_STATUS[6]
+#define PWR_MGMT_1_CYCLE 0x20      // PWR_MGMT_1[5]，休眠与单次采样交替
+#define PWR_MGMT_2_STBY_GYRO 0x07  // STBY_XG | STBY_YG | STBY_ZG
+#define ACCEL_CONFIG_HPF_5HZ 0x01  // ACCEL_CONFIG[2:0]，运动检测使用高通后的数据
+#define FS_SHIFT 3                 // GYRO_CONFIG / ACCEL_CONFIG 中量程位 [4:3]
+#define DATA_REG_SIZE 14           // ACCEL(6) + TEMP(2) + GYRO(6)
+#define DMA_WAIT_TIMEOUT_MS 5      // 等待进行中的一帧 DMA（400kHz 下约 0.4ms）的上限
+
+float g_ax, g_ay, g_az;  // 加速度，单位g
+float g_gx, g_gy, g_gz;  // 角速度，单位°/s
+float g_temp;            // 温度，单位°C
+
+// 采样配置
+static MPU6050_Config_t imu_cfg = MPU6050_CONFIG_DEFAULT;
+static MPU6050_ConfigListener_t config_listeners[MPU6050_CONFIG_LISTENERS_MAX];
+static const uint16_t dlpf_hz[] = {260, 184, 94, 44, 21, 10, 5};  // 按 DLPF_CFG 索引，加速度带宽
+
+// DATA_RDY + DMA 采集状态
+static volatile MPU6050_AcqMode_t acq_mode = MPU6050_ACQ_POLL;  // INT 中断中读取
+static MPU6050_BatchCallback_t batch_callback = NULL;
+// DMA 双缓冲：每组缓存一批原始数据，一组凑满后交给回调时 DMA 已在写另一组
+static uint8_t dma_buf[2][MPU6050_BATCH_FRAMES_MAX][DATA_REG_SIZE];
+static MPU6050_Frame_t batch_frames[MPU6050_BATCH_FRAMES_MAX];
+static uint8_t batch_len = MPU6050_REF_RATE_HZ * 50 / 1000;  // 当前输出速率下每批帧数
+static uint8_t dma_bank = 0;
+static uint8_t dma_slot = 0;
+static volatile bool dma_busy = false;
+static volatile uint32_t missed_frames = 0;  // DATA_RDY 到来时总线忙而丢弃的帧
+
+// 运动唤醒状态
+static volatile bool motion_wake = false;
+static MPU6050_MotionCallback_t motion_callback = NULL;
+
+// 等待进行中的一帧 DMA 读取完成，调用前已停止启动新的读取
+static HAL_StatusTypeDef MPU6050_WaitDmaIdle(void)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (dma_busy) {
+        if (HAL_GetTick() - start > DMA_WAIT_TIMEOUT_MS) {
+            return HAL_TIMEOUT;
+        }
+    }
+    return HAL_OK;
+}
+
+// 写入采样率、DLPF 与量程，运动唤醒模式下保留加速度高通设置
+static HAL_StatusTypeDef MPU6050_WriteConfig(const MPU6050_Config_t *cfg)
+{
+    uint8_t data;
+    HAL_StatusTypeDef res;
+
+    data = (uint8_t)(1000 / cfg->odr_hz - 1);
+    res = HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, SMPLRT_DIV_REG, 1, &data, 1, 100);
+    data = (uint8_t)cfg->dlpf;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, CONFIG_REG, 1, &data, 1, 100);
+    data = (uint8_t)(cfg->gyro_fs << FS_SHIFT);
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, GYRO_CONFIG_REG, 1, &data, 1, 100);
+    data = (uint8_t)(cfg->accel_fs << FS_SHIFT) | (motion_wake ? ACCEL_CONFIG_HPF_5HZ : 0);
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, ACCEL_CONFIG_REG, 1, &data, 1, 100);
+    return (res == HAL_OK) ? HAL_OK : HAL_ERROR;
+}
 
 /* 初始化 MPU6050 */
 HAL_StatusTypeDef MPU6050_Init(void)
@@ -37,71 +109,486 @@ HAL_StatusTypeDef MPU6050_Init(void)
     data = 0x00;
     HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, PWR_MGMT_1_REG, 1, &data, 1, 100);
     HAL_Delay(10);  // 小延迟，等待芯片唤醒稳定
-    // 3. 设置采样率分频器 SMPLRT_DIV (比如设置成7获得1kHz采样率)
-    data = 0x07;
-    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, SMPLRT_DIV_REG, 1, &data, 1, 100);
-    // 4. 配置DLPF，在CONFIG寄存器中设置数字低通滤波器 (例如0x03,Accel带宽44Hz)
-    data = 0x03;
-    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, CONFIG_REG, 1, &data, 1, 100);
-    // 5. 配置陀螺仪满量程范围 ±250°/s (0x00) 和加速度计满量程范围 ±2g (0x00)
-    data = 0x00;
-    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, GYRO_CONFIG_REG, 1, &data, 1, 100);
+    // 3 - 5. 采样率分频 SMPLRT_DIV、DLPF 与量程，默认 200Hz、44Hz、±2g、±250°/s
+    MPU6050_WriteConfig(&imu_cfg);
+    // 6. FIFO 只缓存加速度和陀螺仪，清空后开始写入
+    data = FIFO_EN_GYRO_ACCEL;
+    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, FIFO_EN_REG, 1, &data, 1, 100);
+    MPU6050_FIFO_Reset();
+    // 7. INT 引脚高电平有效、推挽、50us 脉冲，DATA_RDY 中断由采集方式决定
     data = 0x00;
-    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, ACCEL_CONFIG_REG, 1, &data, 1, 100);
+    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, INT_PIN_CFG_REG, 1, &data, 1, 100);
+    return MPU6050_SetAcqMode(acq_mode);
+}
+
+/**
+ * @brief 检查采样配置：输出速率整除 1kHz 且为 20Hz 的整数倍，DLPF 带宽不超过输出速率的一半
+ */
+bool MPU6050_IsConfigValid(const MPU6050_Config_t *cfg)
+{
+    if (cfg->odr_hz < MPU6050_ODR_MIN_HZ || cfg->odr_hz > MPU6050_ODR_MAX_HZ ||
+        1000 % cfg->odr_hz != 0 || cfg->odr_hz % MPU6050_ODR_MIN_HZ != 0) {
+        return false;
+    }
+    if (cfg->dlpf < MPU6050_DLPF_184HZ || cfg->dlpf > MPU6050_DLPF_5HZ ||
+        dlpf_hz[cfg->dlpf] * 2 > cfg->odr_hz) {
+        return false;
+    }
+    return cfg->accel_fs <= MPU6050_ACCEL_FS_16G && cfg->gyro_fs <= MPU6050_GYRO_FS_2000DPS;
+}
+
+/**
+ * @brief 运行时修改输出速率、DLPF 与量程，成功后通知所有监听者
+ *        调用前应停止采集（见 StepCount_SetImuConfig），FIFO 中旧配置的数据由随后的
+ *        MPU6050_SetAcqMode 清空；运动唤醒模式下同样可以调用，退出时按新量程恢复
+ *
+ * @param cfg 新配置
+ * @return HAL_OK 配置成功；HAL_ERROR 配置无效或写入失败（此时不通知监听者）
+ */
+HAL_StatusTypeDef MPU6050_SetConfig(const MPU6050_Config_t *cfg)
+{
+    if (!MPU6050_IsConfigValid(cfg)) {
+        return HAL_ERROR;
+    }
+    if (MPU6050_WriteConfig(cfg) != HAL_OK) {
+        MPU6050_WriteConfig(&imu_cfg);  // 尽量恢复旧配置，保证比例与实际一致
+        return HAL_ERROR;
+    }
+    imu_cfg = *cfg;
+    batch_len = (uint8_t)(cfg->odr_hz * 50 / 1000);
+    dma_slot = 0;
+    for (uint8_t i = 0; i < MPU6050_CONFIG_LISTENERS_MAX; i++) {
+        if (config_listeners[i]) {
+            config_listeners[i](&imu_cfg);
+        }
+    }
     return HAL_OK;
 }
 
-// 读取加速度计三轴原始数据
-void MPU6050_Read_Accel(void)
+const MPU6050_Config_t *MPU6050_GetConfig(void)
 {
-    uint8_t buf[6];
-    HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, 0x3B, 1, buf, 6, 100);
-    // 拼接高低字节为 16 位有符号值
-    Accel_X_RAW = (int16_t)(buf[0] << 8 | buf[1]);
-    Accel_Y_RAW = (int16_t)(buf[2] << 8 | buf[3]);
-    Accel_Z_RAW = (int16_t)(buf[4] << 8 | buf[5]);
+    return &imu_cfg;
 }
 
-// 读取陀螺仪三轴原始数据
-void MPU6050_Read_Gyro(void)
+/**
+ * @brief 注册采样配置监听者，重复注册同一函数只保留一份
+ */
+HAL_StatusTypeDef MPU6050_AddConfigListener(MPU6050_ConfigListener_t listener)
 {
-    uint8_t buf[6];
-    HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, 0x43, 1, buf, 6, 100);
-    Gyro_X_RAW = (int16_t)(buf[0] << 8 | buf[1]);
-    Gyro_Y_RAW = (int16_t)(buf[2] << 8 | buf[3]);
-    Gyro_Z_RAW = (int16_t)(buf[4] << 8 | buf[5]);
+    for (uint8_t i = 0; i < MPU6050_CONFIG_LISTENERS_MAX; i++) {
+        if (config_listeners[i] == listener) {
+            return HAL_OK;
+        }
+    }
+    for (uint8_t i = 0; i < MPU6050_CONFIG_LISTENERS_MAX; i++) {
+        if (config_listeners[i] == NULL) {
+            config_listeners[i] = listener;
+            return HAL_OK;
+        }
+    }
+    return HAL_ERROR;
+}
+
+/**
+ * @brief 当前量程下加速度 1g 对应的原始值
+ */
+uint16_t MPU6050_GetAccelLsbPerG(void)
+{
+    return MPU6050_ACCEL_LSB_PER_G >> imu_cfg.accel_fs;
+}
+
+uint16_t MPU6050_GetDlpfHz(MPU6050_Dlpf_t dlpf)
+{
+    return (dlpf <= MPU6050_DLPF_5HZ) ? dlpf_hz[dlpf] : 0;
+}
+
+static int16_t MPU6050_ScaleUp(int16_t raw, uint8_t shift)
+{
+    int32_t v = (int32_t)raw * (1 << shift);
+    return (int16_t)((v > INT16_MAX) ? INT16_MAX : (v < INT16_MIN) ? INT16_MIN : v);
 }
 
-// 读取温度原始数据
-void MPU6050_Read_Temp(void)
+/**
+ * @brief 把当前量程的原始值换算为参考量程（±2g、±250°/s），超出参考量程的部分饱和
+ *        ±1000°/s 与 ±2000°/s 档的比例 32.8 / 16.4 与 131 相差不到 0.2%，直接移位
+ */
+void MPU6050_ToReference(const MPU6050_Frame_t *in, MPU6050_Frame_t *out)
 {
-    uint8_t buf[2];
-    HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, 0x41, 1, buf, 2, 100);
-    Temp_RAW = (int16_t)(buf[0] << 8 | buf[1]);
+    out->ax = MPU6050_ScaleUp(in->ax, imu_cfg.accel_fs);
+    out->ay = MPU6050_ScaleUp(in->ay, imu_cfg.accel_fs);
+    out->az = MPU6050_ScaleUp(in->az, imu_cfg.accel_fs);
+    out->gx = MPU6050_ScaleUp(in->gx, imu_cfg.gyro_fs);
+    out->gy = MPU6050_ScaleUp(in->gy, imu_cfg.gyro_fs);
+    out->gz = MPU6050_ScaleUp(in->gz, imu_cfg.gyro_fs);
+}
+
+/* 清空 FIFO 并重新使能，帧边界与读指针重新对齐 */
+void MPU6050_FIFO_Reset(void)
+{
+    uint8_t data = USER_CTRL_FIFO_RESET;
+    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, USER_CTRL_REG, 1, &data, 1, 100);
+    data = USER_CTRL_FIFO_EN;
+    HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, USER_CTRL_REG, 1, &data, 1, 100);
+}
+
+/**
+ * @brief 读出 FIFO 中已缓存的完整帧：一次读字节数，一次突发读取全部帧
+ *        FIFO 溢出后最旧的数据被覆盖，帧边界不再可知，此时清空 FIFO 并丢弃本批数据
+ *
+ * @param frames 输出帧（当前量程的原始值），按时间顺序，相邻帧间隔为输出速率的倒数
+ * @param max_frames frames 的容量，多余的帧留在 FIFO 中下次读取
+ * @return 读取的帧数，无数据或出错时为 0
+ */
+uint16_t MPU6050_FIFO_Read(MPU6050_Frame_t *frames, uint16_t max_frames)
+{
+    static uint8_t buf[MPU6050_FIFO_BATCH_MAX * MPU6050_FIFO_FRAME_SIZE];
+    uint8_t cnt[2];
+    uint16_t count, n;
+
+    if (HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, FIFO_COUNTH_REG, 1, cnt, 2, 100) != HAL_OK) {
+        return 0;
+    }
+    count = (uint16_t)(cnt[0] << 8 | cnt[1]);
+    if (count >= MPU6050_FIFO_SIZE) {
+        MPU6050_FIFO_Reset();
+        return 0;
+    }
+
+    n = count / MPU6050_FIFO_FRAME_SIZE;
+    if (n > max_frames) {
+        n = max_frames;
+    }
+    if (n > MPU6050_FIFO_BATCH_MAX) {
+        n = MPU6050_FIFO_BATCH_MAX;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, FIFO_R_W_REG, 1, buf,
+                         n * MPU6050_FIFO_FRAME_SIZE, 100) != HAL_OK) {
+        MPU6050_FIFO_Reset();  // 部分读出的帧会破坏对齐
+        return 0;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        const uint8_t *p = &buf[i * MPU6050_FIFO_FRAME_SIZE];
+        frames[i].ax = (int16_t)(p[0] << 8 | p[1]);
+        frames[i].ay = (int16_t)(p[2] << 8 | p[3]);
+        frames[i].az = (int16_t)(p[4] << 8 | p[5]);
+        frames[i].gx = (int16_t)(p[6] << 8 | p[7]);
+        frames[i].gy = (int16_t)(p[8] << 8 | p[9]);
+        frames[i].gz = (int16_t)(p[10] << 8 | p[11]);
+    }
+    return n;
 }
 
-// 读取所有传感器数据
-void MPU6050_Read_All(void)
+/**
+ * @brief 一次性读取 加速度(6)+温度(2)+陀螺仪(6) 共14字节
+ *        结果只写入调用者的缓冲区，一般通过 sensor_hub 按需调用
+ *
+ * @param frame 加速度与角速度原始值
+ * @param temp_raw 温度原始值
+ * @return HAL_OK 读取成功
+ */
+HAL_StatusTypeDef MPU6050_Read_All(MPU6050_Frame_t *frame, int16_t *temp_raw)
 {
-    uint8_t buf[14];
-    // 一次性读取 加速度(6)+温度(2)+陀螺仪(6) 共14字节
-    HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, 0x3B, 1, buf, 14, 100);
+    uint8_t buf[DATA_REG_SIZE];
+    HAL_StatusTypeDef res;
+
+    res = HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, ACCEL_XOUT_H_REG, 1, buf, DATA_REG_SIZE,
+                           100);
+    if (res != HAL_OK) {
+        return res;
+    }
     // 加速度
-    Accel_X_RAW = (int16_t)(buf[0] << 8 | buf[1]);
-    Accel_Y_RAW = (int16_t)(buf[2] << 8 | buf[3]);
-    Accel_Z_RAW = (int16_t)(buf[4] << 8 | buf[5]);
+    frame->ax = (int16_t)(buf[0] << 8 | buf[1]);
+    frame->ay = (int16_t)(buf[2] << 8 | buf[3]);
+    frame->az = (int16_t)(buf[4] << 8 | buf[5]);
     // 温度
-    Temp_RAW = (int16_t)(buf[6] << 8 | buf[7]);
+    *temp_raw = (int16_t)(buf[6] << 8 | buf[7]);
     // 陀螺仪
-    Gyro_X_RAW = (int16_t)(buf[8] << 8 | buf[9]);
-    Gyro_Y_RAW = (int16_t)(buf[10] << 8 | buf[11]);
-    Gyro_Z_RAW = (int16_t)(buf[12] << 8 | buf[13]);
-    // 转换为物理量
-    g_ax = Accel_X_RAW / 16384.0f;
-    g_ay = Accel_Y_RAW / 16384.0f;
-    g_az = Accel_Z_RAW / 16384.0f;
-    g_gx = Gyro_X_RAW / 131.0f;
-    g_gy = Gyro_Y_RAW / 131.0f;
-    g_gz = Gyro_Z_RAW / 131.0f;
-    g_temp = Temp_RAW / 340.0f + 36.53f;
+    frame->gx = (int16_t)(buf[8] << 8 | buf[9]);
+    frame->gy = (int16_t)(buf[10] << 8 | buf[11]);
+    frame->gz = (int16_t)(buf[12] << 8 | buf[13]);
+    return HAL_OK;
+}
+
+/**
+ * @brief 从 sensor_hub 的最新样本换算浮点物理量（g_ax ... g_temp），仅供显示
+ *        样本超过 MPU6050_FLOAT_VIEW_MAX_AGE_MS 时按需读取总线，只能在任务中调用；
+ *        没有可用样本的量保持上次的值
+ */
+void MPU6050_UpdateFloatView(void)
+{
+    SensorSample_t sample;
+
+    if (SensorHub_Read(SENSOR_CH_ACCEL, MPU6050_FLOAT_VIEW_MAX_AGE_MS, &sample)) {
+        g_ax = (float)sample.v[0] / MPU6050_ACCEL_LSB_PER_G;
+        g_ay = (float)sample.v[1] / MPU6050_ACCEL_LSB_PER_G;
+        g_az = (float)sample.v[2] / MPU6050_ACCEL_LSB_PER_G;
+    }
+    if (SensorHub_Read(SENSOR_CH_GYRO, MPU6050_FLOAT_VIEW_MAX_AGE_MS, &sample)) {
+        g_gx = (float)sample.v[0] / MPU6050_GYRO_LSB_PER_DPS;
+        g_gy = (float)sample.v[1] / MPU6050_GYRO_LSB_PER_DPS;
+        g_gz = (float)sample.v[2] / MPU6050_GYRO_LSB_PER_DPS;
+    }
+    if (SensorHub_Read(SENSOR_CH_IMU_TEMP, MPU6050_FLOAT_VIEW_MAX_AGE_MS, &sample)) {
+        g_temp = (float)MPU6050_TEMP_TO_CENTI_C(sample.v[0]) / 100;
+    }
+}
+
+/**
+ * @brief 切换采集方式
+ *        POLL: 使能 FIFO，关闭 DATA_RDY 中断，由调用者周期性调用 MPU6050_FIFO_Read
+ *        DRDY_DMA: 关闭 FIFO，使能 DATA_RDY 中断，每帧由 DMA 读取数据寄存器
+ *
+ * @param mode 采集方式
+ * @return HAL_OK 配置成功，HAL_ERROR INT 未接线时不支持 DRDY_DMA，
+ *         HAL_TIMEOUT 进行中的 DMA 未完成（保持轮询方式，未改动寄存器）
+ */
+HAL_StatusTypeDef MPU6050_SetAcqMode(MPU6050_AcqMode_t mode)
+{
+    uint8_t int_en = 0x00, fifo_en = 0x00;
+    HAL_StatusTypeDef res;
+
+    if (mode == MPU6050_ACQ_DRDY_DMA && !MPU6050_INT_WIRED) {
+        return HAL_ERROR;  // 收不到 DATA_RDY，采集会停止
+    }
+    // 先停止启动新的 DMA 并等待进行中的一帧完成，再关中断切换
+    acq_mode = MPU6050_ACQ_POLL;
+    if (MPU6050_WaitDmaIdle() != HAL_OK) {
+        return HAL_TIMEOUT;
+    }
+    res = HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, INT_ENABLE_REG, 1, &int_en, 1, 100);
+    if (mode == MPU6050_ACQ_DRDY_DMA) {
+        int_en = INT_ENABLE_DATA_RDY;
+    } else {
+        fifo_en = FIFO_EN_GYRO_ACCEL;
+    }
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, FIFO_EN_REG, 1, &fifo_en, 1, 100);
+    if (mode == MPU6050_ACQ_POLL) {
+        MPU6050_FIFO_Reset();
+    }
+    dma_bank = 0;
+    dma_slot = 0;
+    acq_mode = mode;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, INT_ENABLE_REG, 1, &int_en, 1, 100);
+    return (res == HAL_OK) ? HAL_OK : HAL_ERROR;
+}
+
+MPU6050_AcqMode_t MPU6050_GetAcqMode(void)
+{
+    return acq_mode;
+}
+
+void MPU6050_SetBatchCallback(MPU6050_BatchCallback_t callback)
+{
+    batch_callback = callback;
+}
+
+uint32_t MPU6050_GetMissedFrames(void)
+{
+    return missed_frames;
+}
+
+/**
+ * @brief 读取硬件偏移寄存器
+ *
+ * @param accel 加速度偏移 X/Y/Z（±16g 比例，含 bit0 温度补偿位）
+ * @param gyro 陀螺仪偏移 X/Y/Z（±1000°/s 比例）
+ * @return HAL_OK 读取成功
+ */
+HAL_StatusTypeDef MPU6050_ReadOffsets(int16_t accel[3], int16_t gyro[3])
+{
+    uint8_t buf[6];
+    HAL_StatusTypeDef res;
+
+    res = HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, XA_OFFS_H_REG, 1, buf, 6, 100);
+    if (res != HAL_OK) {
+        return res;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        accel[i] = (int16_t)(buf[2 * i] << 8 | buf[2 * i + 1]);
+    }
+    res = HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, XG_OFFS_USRH_REG, 1, buf, 6, 100);
+    if (res != HAL_OK) {
+        return res;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        gyro[i] = (int16_t)(buf[2 * i] << 8 | buf[2 * i + 1]);
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief 写入硬件偏移寄存器，此后数据寄存器与 FIFO 输出的都是校正后的值
+ *        调用前应停止采集，避免与 FIFO / DMA 读取争用 I2C
+ *
+ * @param accel 加速度偏移 X/Y/Z，bit0 应与读出值保持一致
+ * @param gyro 陀螺仪偏移 X/Y/Z
+ * @return HAL_OK 写入成功
+ */
+HAL_StatusTypeDef MPU6050_WriteOffsets(const int16_t accel[3], const int16_t gyro[3])
+{
+    uint8_t buf[6];
+    HAL_StatusTypeDef res;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        buf[2 * i] = (uint8_t)((uint16_t)accel[i] >> 8);
+        buf[2 * i + 1] = (uint8_t)accel[i];
+    }
+    res = HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, XA_OFFS_H_REG, 1, buf, 6, 100);
+    for (uint8_t i = 0; i < 3; i++) {
+        buf[2 * i] = (uint8_t)((uint16_t)gyro[i] >> 8);
+        buf[2 * i + 1] = (uint8_t)gyro[i];
+    }
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, XG_OFFS_USRH_REG, 1, buf, 6, 100);
+    return (res == HAL_OK) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief 进入运动唤醒模式：停止 FIFO 与 DATA_RDY，陀螺仪待机，加速度计周期唤醒检测运动
+ *        调用前应停止周期性的 FIFO 读取；退出后需重新设置采集方式
+ *
+ * @return HAL_OK 配置成功，HAL_TIMEOUT 进行中的 DMA 未完成
+ */
+HAL_StatusTypeDef MPU6050_EnterMotionWake(void)
+{
+    uint8_t data = 0x00;
+    HAL_StatusTypeDef res;
+
+    acq_mode = MPU6050_ACQ_POLL;
+    if (MPU6050_WaitDmaIdle() != HAL_OK) {
+        return HAL_TIMEOUT;
+    }
+    res = HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, INT_ENABLE_REG, 1, &data, 1, 100);
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, FIFO_EN_REG, 1, &data, 1, 100);
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, USER_CTRL_REG, 1, &data, 1, 100);
+    data = (uint8_t)(imu_cfg.accel_fs << FS_SHIFT) | ACCEL_CONFIG_HPF_5HZ;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, ACCEL_CONFIG_REG, 1, &data, 1, 100);
+    data = MPU6050_WOM_THRESHOLD_MG / 2;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, MOT_THR_REG, 1, &data, 1, 100);
+    data = MPU6050_WOM_DURATION_MS;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, MOT_DUR_REG, 1, &data, 1, 100);
+    data = (MPU6050_WOM_WAKE_CTRL << 6) | PWR_MGMT_2_STBY_GYRO;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, PWR_MGMT_2_REG, 1, &data, 1, 100);
+    data = PWR_MGMT_1_CYCLE;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, PWR_MGMT_1_REG, 1, &data, 1, 100);
+    motion_wake = true;
+    data = INT_ENABLE_MOT;
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, INT_ENABLE_REG, 1, &data, 1, 100);
+    return (res == HAL_OK) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief 退出运动唤醒模式，恢复全速采样的电源与量程配置
+ *        FIFO 与中断保持关闭，由随后的 MPU6050_SetAcqMode 重新配置
+ *        不等待陀螺仪退出待机，调用者在 MPU6050_WAKE_SETTLE_MS 之后再开始采集
+ *
+ * @return HAL_OK 配置成功
+ */
+HAL_StatusTypeDef MPU6050_ExitMotionWake(void)
+{
+    uint8_t data = 0x00;
+    HAL_StatusTypeDef res;
+
+    motion_wake = false;
+    res = HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, INT_ENABLE_REG, 1, &data, 1, 100);
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, PWR_MGMT_1_REG, 1, &data, 1, 100);
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, PWR_MGMT_2_REG, 1, &data, 1, 100);
+    data = (uint8_t)(imu_cfg.accel_fs << FS_SHIFT);  // 关闭高通，保留量程
+    res |= HAL_I2C_Mem_Write(&MPU6050_HI2C, MPU6050_ADDR, ACCEL_CONFIG_REG, 1, &data, 1, 100);
+    return (res == HAL_OK) ? HAL_OK : HAL_ERROR;
+}
+
+bool MPU6050_IsMotionWake(void)
+{
+    return motion_wake;
+}
+
+/**
+ * @brief 运动唤醒模式下查询 INT_STATUS 的运动标志（读取后清零），供 INT 未接线时轮询
+ *
+ * @return true 上次查询以来检测到运动
+ */
+bool MPU6050_PollMotion(void)
+{
+    uint8_t status;
+    HAL_StatusTypeDef res;
+
+    if (!motion_wake) {
+        return false;
+    }
+    res = HAL_I2C_Mem_Read(&MPU6050_HI2C, MPU6050_ADDR, INT_STATUS_REG, 1, &status, 1, 100);
+    if (res != HAL_OK) {
+        return false;
+    }
+    return (status & INT_STATUS_MOT) != 0;
+}
+
+void MPU6050_SetMotionCallback(MPU6050_MotionCallback_t callback)
+{
+    motion_callback = callback;
+}
+
+/**
+ * @brief INT 引脚上升沿（EXTI 回调中调用）
+ *        运动唤醒模式下通知检测到运动，DATA_RDY 方式下启动一帧数据寄存器的 DMA 读取，
+ *        总线被阻塞读取占用或上一帧尚未完成时丢弃本帧
+ */
+void MPU6050_IntHandler(void)
+{
+    if (motion_wake) {
+        if (motion_callback) {
+            motion_callback();
+        }
+        return;
+    }
+    if (acq_mode != MPU6050_ACQ_DRDY_DMA) {
+        return;
+    }
+    if (dma_busy || HAL_I2C_Mem_Read_DMA(&MPU6050_HI2C, MPU6050_ADDR, ACCEL_XOUT_H_REG, 1,
+                                         dma_buf[dma_bank][dma_slot], DATA_REG_SIZE) != HAL_OK) {
+        missed_frames++;
+        return;
+    }
+    dma_busy = true;
+}
+
+/**
+ * @brief 一帧 DMA 读取完成（HAL_I2C_MemRxCpltCallback 中调用）
+ *        一批凑满后切换到另一组缓冲，解析本组并交给回调
+ */
+void MPU6050_DmaCpltHandler(void)
+{
+    uint8_t bank = dma_bank;
+
+    dma_busy = false;
+    if (++dma_slot < batch_len) {
+        return;
+    }
+    dma_slot = 0;
+    dma_bank ^= 1;
+
+    for (uint8_t i = 0; i < batch_len; i++) {
+        const uint8_t *p = dma_buf[bank][i];
+        batch_frames[i].ax = (int16_t)(p[0] << 8 | p[1]);
+        batch_frames[i].ay = (int16_t)(p[2] << 8 | p[3]);
+        batch_frames[i].az = (int16_t)(p[4] << 8 | p[5]);
+        // p[6..7] 为温度，不使用
+        batch_frames[i].gx = (int16_t)(p[8] << 8 | p[9]);
+        batch_frames[i].gy = (int16_t)(p[10] << 8 | p[11]);
+        batch_frames[i].gz = (int16_t)(p[12] << 8 | p[13]);
+    }
+    if (batch_callback) {
+        batch_callback(batch_frames, batch_len);
+    }
+}
+
+/**
+ * @brief DMA 读取出错（HAL_I2C_ErrorCallback 中调用），丢弃本帧
+ */
+void MPU6050_DmaErrorHandler(void)
+{
+    dma_busy = false;
+    missed_frames++;
 }
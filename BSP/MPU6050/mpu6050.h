@@ -1,16 +1,149 @@
 #ifndef __MPU6050_H
 #define __MPU6050_H
 
+#include <stdbool.h>
+
 #include "i2c.h"
 
+// 参考格式：各算法按 200Hz、±2g、±250°/s 的原始值调校，数据通路全程使用 int16 原始值
+// 采样配置改变后，FIFO / DMA 输出的是实际量程的原始值，由 MPU6050_ToReference 换算回参考量程
+#define MPU6050_ACCEL_LSB_PER_G 16384
+#define MPU6050_GYRO_LSB_PER_DPS 131
+#define MPU6050_REF_RATE_HZ 200
+#define MPU6050_TEMP_LSB_PER_C 340
+#define MPU6050_TEMP_OFFSET_CENTI 3653  // 0 LSB 对应 36.53°C
+
+// 浮点物理量仅供显示，由 MPU6050_UpdateFloatView() 从 sensor_hub 的缓存换算
 extern float g_ax, g_ay, g_az;  // 加速度，单位g
 extern float g_gx, g_gy, g_gz;  // 角速度，单位°/s
 extern float g_temp;            // 温度，单位°C
+#define MPU6050_FLOAT_VIEW_MAX_AGE_MS 100  // 缓存超过该年龄时浮点视图按需读取总线
+
+// 定点换算，只在需要给人看的地方使用
+#define MPU6050_ACCEL_TO_MG(raw) ((int32_t)(raw) * 1000 / MPU6050_ACCEL_LSB_PER_G)
+#define MPU6050_GYRO_TO_CENTI_DPS(raw) ((int32_t)(raw) * 100 / MPU6050_GYRO_LSB_PER_DPS)
+#define MPU6050_TEMP_TO_CENTI_C(raw) \
+    ((int32_t)(raw) * 100 / MPU6050_TEMP_LSB_PER_C + MPU6050_TEMP_OFFSET_CENTI)
+
+// 输出速率 = 1kHz / (1 + SMPLRT_DIV)（DLPF 开启时陀螺仪输出 1kHz），必须整除 1kHz，
+// 且为 20Hz 的整数倍，保证每 50ms 一批的帧数为整数
+#define MPU6050_ODR_MIN_HZ 20
+#define MPU6050_ODR_MAX_HZ 1000
+
+// DLPF 带宽 (CONFIG[2:0])，不使用 0：关闭 DLPF 时陀螺仪输出 8kHz，分频关系不同
+typedef enum {
+    MPU6050_DLPF_184HZ = 1,
+    MPU6050_DLPF_94HZ,
+    MPU6050_DLPF_44HZ,
+    MPU6050_DLPF_21HZ,
+    MPU6050_DLPF_10HZ,
+    MPU6050_DLPF_5HZ
+} MPU6050_Dlpf_t;
+
+// 满量程 (ACCEL_CONFIG[4:3] / GYRO_CONFIG[4:3])，每升一档比例减半
+typedef enum {
+    MPU6050_ACCEL_FS_2G = 0,
+    MPU6050_ACCEL_FS_4G,
+    MPU6050_ACCEL_FS_8G,
+    MPU6050_ACCEL_FS_16G
+} MPU6050_AccelFs_t;
+
+typedef enum {
+    MPU6050_GYRO_FS_250DPS = 0,
+    MPU6050_GYRO_FS_500DPS,
+    MPU6050_GYRO_FS_1000DPS,
+    MPU6050_GYRO_FS_2000DPS
+} MPU6050_GyroFs_t;
+
+typedef struct {
+    uint16_t odr_hz;              // FIFO / DATA_RDY 输出速率
+    MPU6050_Dlpf_t dlpf;          // 带宽不得超过输出速率的一半
+    MPU6050_AccelFs_t accel_fs;
+    MPU6050_GyroFs_t gyro_fs;
+} MPU6050_Config_t;
+
+#define MPU6050_CONFIG_DEFAULT \
+    {MPU6050_REF_RATE_HZ, MPU6050_DLPF_44HZ, MPU6050_ACCEL_FS_2G, MPU6050_GYRO_FS_250DPS}
+#define MPU6050_CONFIG_LISTENERS_MAX 4
+
+// FIFO 缓存加速度 + 陀螺仪（不含温度），按批读取
+#define MPU6050_FIFO_SIZE 1024      // FIFO 字节数
+#define MPU6050_FIFO_FRAME_SIZE 12  // 每帧 ACCEL_XOUT..ZOUT + GYRO_XOUT..ZOUT
+#define MPU6050_FIFO_BATCH_MAX 64   // 单次最多读取的帧数 (768 字节)，1kHz 下 50ms 为 50 帧
+
+typedef struct {
+    int16_t ax, ay, az;  // 加速度原始值
+    int16_t gx, gy, gz;  // 角速度原始值
+} MPU6050_Frame_t;
+
+// 采样配置改变后在调用 MPU6050_SetConfig 的上下文中调用（此时采集已停止）
+typedef void (*MPU6050_ConfigListener_t)(const MPU6050_Config_t *cfg);
+
+// 采集方式
+typedef enum {
+    MPU6050_ACQ_POLL = 0,  // TIM6 每 10ms 读取 FIFO（阻塞 I2C，每次帧数有限）
+    MPU6050_ACQ_DRDY_DMA   // INT 引脚 DATA_RDY 触发 DMA 读取，凑满一批后回调
+} MPU6050_AcqMode_t;
+
+// 1: MPU6050 的 INT 已接到 MPU6050_INT 引脚（PE5），可以使用 DATA_RDY 与运动唤醒中断
+// 0: 只能轮询 FIFO，DRDY_DMA 方式被拒绝；当前板上未确认接线，默认为 0，接线后在工程中定义为 1
+#ifndef MPU6050_INT_WIRED
+#define MPU6050_INT_WIRED 0
+#endif
+
+#ifndef MPU6050_ACQ_MODE_DEFAULT
+#if MPU6050_INT_WIRED
+#define MPU6050_ACQ_MODE_DEFAULT MPU6050_ACQ_DRDY_DMA
+#else
+#define MPU6050_ACQ_MODE_DEFAULT MPU6050_ACQ_POLL
+#endif
+#endif
+#define MPU6050_BATCH_FRAMES_MAX (MPU6050_ODR_MAX_HZ * 50 / 1000)  // 每批 50ms，帧数随输出速率变化
+
+// 一批帧凑满时在中断上下文中调用
+typedef void (*MPU6050_BatchCallback_t)(const MPU6050_Frame_t *frames, uint16_t n);
+
+// 运动唤醒（低功耗）：陀螺仪待机，加速度计按 LP_WAKE_CTRL 周期性唤醒采样，超过阈值时 INT 输出脉冲
+// 并置位 INT_STATUS 的运动标志；INT 未接线时由任务调用 MPU6050_PollMotion 查询
+#define MPU6050_WOM_THRESHOLD_MG 40  // 高通滤波后任一轴超过该值视为运动（MOT_THR 1LSB = 2mg）
+#define MPU6050_WOM_DURATION_MS 1    // 超过阈值的持续时间（MOT_DUR 1LSB = 1ms）
+#define MPU6050_WOM_WAKE_CTRL 3      // LP_WAKE_CTRL：0=1.25Hz 1=5Hz 2=20Hz 3=40Hz
+                                    // 40Hz 使跌倒的失重在 25ms 内触发唤醒，恢复采集时尚未冲击
+#define MPU6050_WAKE_SETTLE_MS 10    // 退出运动唤醒后陀螺仪退出待机所需的时间
+
+// 硬件偏移寄存器的比例与量程设置无关：加速度 ±16g 量程，陀螺仪 ±1000°/s 量程
+// 加速度偏移寄存器 bit0 为出厂温度补偿位，写入时必须保留
+#define MPU6050_ACCEL_OFFSET_LSB_PER_G 2048
+#define MPU6050_GYRO_OFFSET_LSB_PER_10DPS 328  // 32.8 LSB/(°/s)
+
+// 检测到运动时在中断上下文中调用
+typedef void (*MPU6050_MotionCallback_t)(void);
 
 HAL_StatusTypeDef MPU6050_Init(void);
-void MPU6050_Read_Accel(void);
-void MPU6050_Read_Gyro(void);
-void MPU6050_Read_Temp(void);
-void MPU6050_Read_All(void);
+bool MPU6050_IsConfigValid(const MPU6050_Config_t *cfg);
+HAL_StatusTypeDef MPU6050_SetConfig(const MPU6050_Config_t *cfg);
+const MPU6050_Config_t *MPU6050_GetConfig(void);
+HAL_StatusTypeDef MPU6050_AddConfigListener(MPU6050_ConfigListener_t listener);
+uint16_t MPU6050_GetAccelLsbPerG(void);
+uint16_t MPU6050_GetDlpfHz(MPU6050_Dlpf_t dlpf);
+void MPU6050_ToReference(const MPU6050_Frame_t *in, MPU6050_Frame_t *out);
+HAL_StatusTypeDef MPU6050_Read_All(MPU6050_Frame_t *frame, int16_t *temp_raw);
+void MPU6050_UpdateFloatView(void);
+void MPU6050_FIFO_Reset(void);
+uint16_t MPU6050_FIFO_Read(MPU6050_Frame_t *frames, uint16_t max_frames);
+HAL_StatusTypeDef MPU6050_SetAcqMode(MPU6050_AcqMode_t mode);
+MPU6050_AcqMode_t MPU6050_GetAcqMode(void);
+void MPU6050_SetBatchCallback(MPU6050_BatchCallback_t callback);
+uint32_t MPU6050_GetMissedFrames(void);
+HAL_StatusTypeDef MPU6050_ReadOffsets(int16_t accel[3], int16_t gyro[3]);
+HAL_StatusTypeDef MPU6050_WriteOffsets(const int16_t accel[3], const int16_t gyro[3]);
+HAL_StatusTypeDef MPU6050_EnterMotionWake(void);
+HAL_StatusTypeDef MPU6050_ExitMotionWake(void);
+bool MPU6050_IsMotionWake(void);
+bool MPU6050_PollMotion(void);
+void MPU6050_SetMotionCallback(MPU6050_MotionCallback_t callback);
+void MPU6050_IntHandler(void);
+void MPU6050_DmaCpltHandler(void);
+void MPU6050_DmaErrorHandler(void);
 
 #endif
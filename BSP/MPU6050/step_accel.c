@@ -0,0 +1,145 @@
+#include "step_accel.h"
+
+#include <string.h>
+
+#include "int_math.h"
+
+#define MS_TO_SAMPLES(ms) ((uint32_t)(ms) * STEP_ACCEL_SAMPLE_HZ / 1000)
+
+void step_accel_init(StepAccel_t *ps_st)
+{
+    memset(ps_st, 0, sizeof(*ps_st));
+}
+
+/**
+ * @brief 一个候选步（峰值）通过间隔检查后的计数逻辑
+ *
+ * @return 本次计入的步数
+ */
+static uint8_t step_accel_on_peak(StepAccel_t *ps_st, uint32_t un_peak_idx)
+{
+    uint32_t un_interval = un_peak_idx - ps_st->un_last_step;
+    uint32_t un_tol;
+
+    if (ps_st->uch_pending == 0 && !ps_st->uch_walking) {
+        // 序列的第一个峰，只作为间隔起点
+        ps_st->un_last_step = un_peak_idx;
+        ps_st->uch_pending = 1;
+        ps_st->un_avg_interval = 0;
+        return 0;
+    }
+    ps_st->un_last_step = un_peak_idx;
+    if (un_interval < MS_TO_SAMPLES(STEP_ACCEL_MIN_INTERVAL_MS)) {
+        // 越过滞回的峰比行走快：晃动或振动，其次谐波间隔也会显得规律，重新开始确认
+        ps_st->uch_walking = 0;
+        ps_st->uch_pending = 1;
+        ps_st->un_avg_interval = 0;
+        return 0;
+    }
+    if (ps_st->un_avg_interval != 0) {
+        un_tol = ps_st->un_avg_interval * STEP_ACCEL_REGULARITY_PCT / 100;
+        if (un_interval + un_tol < ps_st->un_avg_interval ||
+            un_interval > ps_st->un_avg_interval + un_tol) {
+            // 节奏突变：重新开始确认，已计入的步保留
+            ps_st->uch_walking = 0;
+            ps_st->uch_pending = 1;
+            ps_st->un_avg_interval = 0;
+            return 0;
+        }
+        ps_st->un_avg_interval += ((int32_t)un_interval - (int32_t)ps_st->un_avg_interval) / 4;
+    } else {
+        ps_st->un_avg_interval = un_interval;
+    }
+
+    if (ps_st->uch_walking) {
+        return 1;
+    }
+    if (++ps_st->uch_pending >= STEP_ACCEL_CONFIRM) {
+        // 确认在行走，把确认期间的步一并计入
+        ps_st->uch_walking = 1;
+        ps_st->uch_pending = 0;
+        return STEP_ACCEL_CONFIRM;
+    }
+    return 0;
+}
+
+/**
+ * @brief 输入一帧加速度原始值
+ *
+ * @param ps_st 检测器状态
+ * @param w_ax X 轴加速度原始值
+ * @param w_ay Y 轴加速度原始值
+ * @param w_az Z 轴加速度原始值
+ * @return 本帧计入的步数（确认行走时可能一次计入多步）
+ */
+uint8_t step_accel_update(StepAccel_t *ps_st, int16_t w_ax, int16_t w_ay, int16_t w_az)
+{
+    int32_t n_mag, n_sig, n_mid, n_hyst;
+    uint8_t uch_steps = 0;
+
+    n_mag = (int32_t)isqrt32(mag_sq3(w_ax, w_ay, w_az));
+    if (!ps_st->uch_primed) {
+        ps_st->n_lp = n_mag << STEP_ACCEL_LPF_SHIFT;
+        ps_st->n_base = n_mag << STEP_ACCEL_BASE_SHIFT;
+        ps_st->uch_primed = 1;
+    }
+    ps_st->un_idx++;
+
+    // 一阶低通去除冲击高频，慢速低通跟踪重力基线
+    ps_st->n_lp += n_mag - (ps_st->n_lp >> STEP_ACCEL_LPF_SHIFT);
+    ps_st->n_base += n_mag - (ps_st->n_base >> STEP_ACCEL_BASE_SHIFT);
+    n_sig = (ps_st->n_lp >> STEP_ACCEL_LPF_SHIFT) - (ps_st->n_base >> STEP_ACCEL_BASE_SHIFT);
+
+    // 峰谷包络：被信号推高/压低，否则向基线衰减
+    ps_st->n_peak_env -= ps_st->n_peak_env >> STEP_ACCEL_DECAY_SHIFT;
+    ps_st->n_valley_env -= ps_st->n_valley_env >> STEP_ACCEL_DECAY_SHIFT;
+    if (n_sig > ps_st->n_peak_env)
+        ps_st->n_peak_env = n_sig;
+    if (n_sig < ps_st->n_valley_env)
+        ps_st->n_valley_env = n_sig;
+
+    // 自适应阈值：包络中线 ± 1/4 峰谷差（滞回）
+    n_mid = (ps_st->n_peak_env + ps_st->n_valley_env) / 2;
+    n_hyst = (ps_st->n_peak_env - ps_st->n_valley_env) / 4;
+
+    if (ps_st->n_peak_env - ps_st->n_valley_env >= STEP_ACCEL_MIN_P2P) {
+        if (!ps_st->uch_above) {
+            if (n_sig > n_mid + n_hyst) {
+                ps_st->uch_above = 1;
+                ps_st->n_max = n_sig;
+                ps_st->un_max_idx = ps_st->un_idx;
+            }
+        } else if (n_sig > ps_st->n_max) {
+            ps_st->n_max = n_sig;
+            ps_st->un_max_idx = ps_st->un_idx;
+        } else if (n_sig < n_mid - n_hyst) {
+            // 回落到阈值下方，上半周期的最大值即一个候选步
+            ps_st->uch_above = 0;
+            uch_steps = step_accel_on_peak(ps_st, ps_st->un_max_idx);
+        }
+    } else {
+        ps_st->uch_above = 0;
+    }
+
+    // 长时间没有新步：停止行走，下一段重新确认
+    if ((ps_st->uch_walking || ps_st->uch_pending) &&
+        ps_st->un_idx - ps_st->un_last_step > MS_TO_SAMPLES(STEP_ACCEL_MAX_INTERVAL_MS)) {
+        ps_st->uch_walking = 0;
+        ps_st->uch_pending = 0;
+        ps_st->un_avg_interval = 0;
+    }
+    return uch_steps;
+}
+
+/**
+ * @brief 当前步频
+ *
+ * @return 步/分钟，未在行走时为 0
+ */
+uint16_t step_accel_cadence(const StepAccel_t *ps_st)
+{
+    if (!ps_st->uch_walking || ps_st->un_avg_interval == 0) {
+        return 0;
+    }
+    return (uint16_t)(60UL * STEP_ACCEL_SAMPLE_HZ / ps_st->un_avg_interval);
+}
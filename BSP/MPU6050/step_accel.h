@@ -0,0 +1,55 @@
+/**
+ * @file step_accel.h
+ * @author Shiki
+ * @brief Step detector on the low-pass filtered acceleration magnitude.
+ *        The magnitude is independent of how the wrist is oriented. The gravity
+ *        baseline is tracked and removed, and steps are the peaks of what is left.
+ *        Peak / valley envelopes decay towards the baseline, so the detection
+ *        threshold follows the walking intensity in both directions. A peak only
+ *        becomes a step if its interval to the previous one is plausible and close
+ *        to the running average; the first STEP_ACCEL_CONFIRM regular steps are
+ *        held back and credited together, which rejects isolated bumps.
+ *        Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ * @version 0.1
+ * @date 2025-10-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __STEP_ACCEL_H
+#define __STEP_ACCEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STEP_ACCEL_SAMPLE_HZ 200         // 输入采样率，即 MPU6050 参考帧率
+#define STEP_ACCEL_LPF_SHIFT 3           // 幅值低通，200Hz 下截止约 4Hz
+#define STEP_ACCEL_BASE_SHIFT 8          // 重力基线跟踪，约 0.12Hz
+#define STEP_ACCEL_DECAY_SHIFT 7         // 包络向基线衰减，时间常数约 0.64s
+#define STEP_ACCEL_MIN_P2P 1300          // 峰谷差下限（原始 LSB，约 0.08g）
+#define STEP_ACCEL_MIN_INTERVAL_MS 250   // 4 步/秒，间隔更短的峰视为晃动
+#define STEP_ACCEL_MAX_INTERVAL_MS 2000  // 超过该间隔视为停止行走
+#define STEP_ACCEL_REGULARITY_PCT 40     // 与平均步间隔偏差超过该比例视为不规律
+#define STEP_ACCEL_CONFIRM 4             // 连续规律步数达到该值后开始计数
+
+typedef struct {
+    int32_t n_lp;              // 低通后的幅值 (LSB << LPF_SHIFT)
+    int32_t n_base;            // 重力基线 (LSB << BASE_SHIFT)
+    int32_t n_peak_env;        // 峰值包络（去基线）
+    int32_t n_valley_env;      // 谷值包络（去基线）
+    int32_t n_max;             // 当前上半周期的最大值
+    uint32_t un_max_idx;       // 最大值对应的样本序号
+    uint32_t un_idx;           // 样本序号
+    uint32_t un_last_step;     // 上一个候选步的样本序号
+    uint32_t un_avg_interval;  // 平均步间隔（样本数），0 表示尚未建立
+    uint8_t uch_above;         // 当前处于阈值上方
+    uint8_t uch_pending;       // 尚未确认的规律步数
+    uint8_t uch_walking;       // 已确认在行走，新步立即计入
+    uint8_t uch_primed;        // 滤波器已用第一个样本初始化
+} StepAccel_t;
+
+void step_accel_init(StepAccel_t *ps_st);
+uint8_t step_accel_update(StepAccel_t *ps_st, int16_t w_ax, int16_t w_ay, int16_t w_az);
+uint16_t step_accel_cadence(const StepAccel_t *ps_st);
+
+#endif
@@ -1,11 +1,18 @@
 #include "step_count.h"
 
+#include <string.h>
+
+#include "fall_alert.h"
+#include "imu_calib.h"
+#include "motion_energy.h"
+#include "sensor_hub.h"
+#include "step_accel.h"
 #include "tim.h"
+#include "wrist_gesture.h"
 
 #define ABS(a) (0 - (a)) > 0 ? (-(a)) : (a)  // 取a的绝对值
 #define MAX(a, b) ((a) > (b) ? (a) : (b))    // 取a和b的较大值
 #define MIN(a, b) ((a) < (b) ? (a) : (b))    // 取a和b的较小值
-#define SAMPLE_NUM 10                        // 采样10次取平均值
 #define MIN_RELIABLE_VARIATION 200           // 最小可信赖变化量
 #define MAX_RELIABLE_VARIATION 5000          // 最大可信赖变化量
 
@@ -33,30 +40,58 @@ typedef struct {
 
 peak_value_t peak_value;
 
-void Gyro_sample_update(void)
+static MPU6050_Frame_t fifo_frames[MPU6050_FIFO_BATCH_MAX];
+static uint16_t fifo_count;  // 轮询方式下本批已读取的帧数
+static uint8_t poll_ticks;   // 本批已经过的 TIM6 周期数
+
+// 算法按参考格式调校：输入帧先换算到参考量程，再按整数倍插值或平均到参考帧率
+static MPU6050_Frame_t ref_frames[MPU6050_FIFO_BATCH_MAX];
+static uint8_t resample_up = 1;    // 参考帧率 / 输出速率，线性插值
+static uint8_t resample_down = 1;  // 输出速率 / 参考帧率，逐组平均
+static uint8_t resample_count;
+static int32_t resample_sum[6];
+static MPU6050_Frame_t resample_prev;
+static bool resample_has_prev;
+
+static const char *const step_engine_names[STEP_ENGINE_COUNT] = {"Gyro", "Accel"};
+static StepEngine_t step_engine = STEP_ENGINE_DEFAULT;
+static volatile StepEngine_t step_engine_request = STEP_ENGINE_DEFAULT;  // 在下一批数据时生效
+static StepAccel_t step_accel;
+
+// 电源管理：静止时 IMU 处于运动唤醒模式
+static MPU6050_AcqMode_t step_acq_mode = MPU6050_ACQ_POLL;  // 全速采样时使用的采集方式
+static bool step_idle = false;
+static bool step_waking = false;                // 已退出运动唤醒，等待陀螺仪稳定后恢复采样
+static uint32_t step_wake_tick;
+static volatile bool step_motion_flag = false;  // 运动唤醒中断已触发，等待任务恢复采样
+static uint16_t idle_last_step;
+static uint32_t idle_last_active_tick;
+
+static volatile WristEvent_t wrist_event = WRIST_EVENT_NONE;  // 最近一次手势，由任务取走
+
+void Gyro_sample_update(const MPU6050_Frame_t *frames, uint16_t n)
 {
-    axis_value_t GyroValue;
     axis_value_t change;
-    int sum[3] = {0};
+    int32_t sum[3] = {0};
 
     // 保存上一次测量的原始数据
     old_ave_GyroValue.X = ave_GyroValue.X;
     old_ave_GyroValue.Y = ave_GyroValue.Y;
     old_ave_GyroValue.Z = ave_GyroValue.Z;
 
-    // 多次测量取平均值
-    for (uint8_t i = 0; i < SAMPLE_NUM; i++) {
-        MPU6050_Read_All();
-        GyroValue.X = g_gx;
-        GyroValue.Y = g_gy;
-        GyroValue.Z = g_gz;
-        sum[0] += GyroValue.X;
-        sum[1] += GyroValue.Y;
-        sum[2] += GyroValue.Z;
+    // 一批帧（约 50ms，200Hz 下 10 帧）取平均值
+    if (n == 0) {
+        return;  // 没有新数据，保持上次结果，变化量为 0
     }
-    ave_GyroValue.X = sum[0] / SAMPLE_NUM;
-    ave_GyroValue.Y = sum[1] / SAMPLE_NUM;
-    ave_GyroValue.Z = sum[2] / SAMPLE_NUM;
+    for (uint16_t i = 0; i < n; i++) {
+        sum[0] += frames[i].gx;
+        sum[1] += frames[i].gy;
+        sum[2] += frames[i].gz;
+    }
+    // 角速度平均值换算为 °/s，整数运算
+    ave_GyroValue.X = sum[0] / (n * MPU6050_GYRO_LSB_PER_DPS);
+    ave_GyroValue.Y = sum[1] / (n * MPU6050_GYRO_LSB_PER_DPS);
+    ave_GyroValue.Z = sum[2] / (n * MPU6050_GYRO_LSB_PER_DPS);
 
     // 原始数据变化量
     change.X = ABS(ave_GyroValue.X - old_ave_GyroValue.X);
@@ -83,13 +118,13 @@ void Gyro_sample_update(void)
     peak_value.min.Z = MIN(peak_value.min.Z, ave_GyroValue.Z);
 }
 
-void which_is_active(void)
+void which_is_active(const MPU6050_Frame_t *frames, uint16_t n)
 {
     axis_value_t change;
     static axis_value_t active;  // 三个轴的活跃度权重
     static uint8_t active_sample_num;
 
-    Gyro_sample_update();
+    Gyro_sample_update(frames, n);
     active_sample_num++;
 
     // 每隔一段时间，比较一次权重大小，判断最活跃轴
@@ -126,10 +161,10 @@ void which_is_active(void)
 
 uint16_t step_count;
 
-void detect_step(void)
+void detect_step(const MPU6050_Frame_t *frames, uint16_t n)
 {
     int16_t mid;
-    which_is_active();
+    which_is_active(frames, n);
     switch (most_active_axis) {
         case ACTIVE_NULL:
             break;
@@ -165,11 +200,61 @@ void detect_step(void)
 
 uint16_t g_step;
 
-void Timer_Handler_StepCount(void)
+// 同一批加速度数据顺带用于 PPG 运动门控
+static void StepCount_UpdateMotion(const MPU6050_Frame_t *frames, uint16_t n)
+{
+    int32_t accel_sum[3] = {0};
+
+    if (n == 0) {
+        return;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        accel_sum[0] += frames[i].ax;
+        accel_sum[1] += frames[i].ay;
+        accel_sum[2] += frames[i].az;
+    }
+    MotionEnergy_Update(accel_sum[0] / n, accel_sum[1] / n, accel_sum[2] / n);
+}
+
+// 处理一批参考格式的数据：计步、运动能量、活动分类、抬腕检测与校准采集
+static void StepCount_ProcessRef(const MPU6050_Frame_t *frames, uint16_t n)
 {
     static uint8_t step_time_count = 0;
 
-    detect_step();
+    // 切换算法在处理数据的上下文中完成，新算法从空状态开始
+    if (step_engine_request != step_engine) {
+        step_engine = step_engine_request;
+        step_accel_init(&step_accel);
+        step_count = 0;
+        step_time_count = 0;
+    }
+
+    StepCount_UpdateMotion(frames, n);
+    if (n != 0) {
+        // 最新一帧作为加速度/角速度通道的缓存，其他读者不必再访问总线
+        SensorHub_Publish(SENSOR_CH_ACCEL, &frames[n - 1].ax, HAL_GetTick());
+        SensorHub_Publish(SENSOR_CH_GYRO, &frames[n - 1].gx, HAL_GetTick());
+    }
+    ImuCalib_Feed(frames, n);
+    // 活动分类、抬腕检测与计步算法无关，逐帧输入；活动分类的评估在 Task_StepPower 中进行
+    for (uint16_t i = 0; i < n; i++) {
+        WristEvent_t event;
+        activity_push(frames[i].ax, frames[i].ay, frames[i].az);
+        event = wrist_gesture_push(frames[i].ax, frames[i].ay, frames[i].az, frames[i].gx,
+                                   frames[i].gy);
+        if (event != WRIST_EVENT_NONE) {
+            wrist_event = event;
+        }
+    }
+    if (step_engine == STEP_ENGINE_ACCEL_MAG) {
+        // 逐帧判定，不需要凑满 300ms
+        for (uint16_t i = 0; i < n; i++) {
+            g_step += step_accel_update(&step_accel, frames[i].ax, frames[i].ay, frames[i].az);
+        }
+        return;
+    }
+
+    detect_step(frames, n);
     step_time_count++;
     if (step_time_count == 6)  // 300ms
     {
@@ -180,3 +265,317 @@ void Timer_Handler_StepCount(void)
         }
     }
 }
+
+// 追加一帧参考帧率的数据，缓冲区满时先处理已有的帧（只在批间隔异常变长时发生）
+static uint16_t StepCount_Emit(const MPU6050_Frame_t *frame, uint16_t m)
+{
+    if (m == MPU6050_FIFO_BATCH_MAX) {
+        StepCount_ProcessRef(ref_frames, m);
+        m = 0;
+    }
+    ref_frames[m] = *frame;
+    return m + 1;
+}
+
+// 一帧参考量程的数据换算到参考帧率，返回 ref_frames 中的帧数
+static uint16_t StepCount_Resample(const MPU6050_Frame_t *frame, uint16_t m)
+{
+    MPU6050_Frame_t out;
+    const int16_t *v = &frame->ax;
+    int16_t *o = &out.ax;
+
+    if (resample_down > 1) {
+        for (uint8_t k = 0; k < 6; k++) {
+            resample_sum[k] += v[k];
+        }
+        if (++resample_count < resample_down) {
+            return m;
+        }
+        for (uint8_t k = 0; k < 6; k++) {
+            o[k] = (int16_t)(resample_sum[k] / resample_down);
+            resample_sum[k] = 0;
+        }
+        resample_count = 0;
+        return StepCount_Emit(&out, m);
+    }
+    if (resample_up > 1) {
+        const int16_t *p = resample_has_prev ? &resample_prev.ax : v;
+        for (uint8_t i = 1; i <= resample_up; i++) {
+            for (uint8_t k = 0; k < 6; k++) {
+                o[k] = (int16_t)(p[k] + ((int32_t)v[k] - p[k]) * i / resample_up);
+            }
+            m = StepCount_Emit(&out, m);
+        }
+        resample_prev = *frame;
+        resample_has_prev = true;
+        return m;
+    }
+    return StepCount_Emit(frame, m);
+}
+
+/**
+ * @brief 处理一批约 50ms 的 IMU 数据（当前采样配置的原始值）
+ *        轮询方式下在 TIM6 中断中调用，DATA_RDY 方式下作为 MPU6050 的批回调
+ */
+void StepCount_ProcessBatch(const MPU6050_Frame_t *frames, uint16_t n)
+{
+    uint16_t m = 0;
+
+    // 跌倒检测需要超出参考量程的冲击峰值，使用换算前的原始帧
+    FallAlert_ProcessBatch(frames, n);
+    for (uint16_t i = 0; i < n; i++) {
+        MPU6050_Frame_t frame;
+        MPU6050_ToReference(&frames[i], &frame);
+        m = StepCount_Resample(&frame, m);
+    }
+    StepCount_ProcessRef(ref_frames, m);
+}
+
+/**
+ * @brief 采样配置改变（采集已停止）：重新计算换算倍数，丢弃未凑满的平均组与插值起点
+ *        算法状态保留，换算后输入格式不变，步数与分类不受影响
+ */
+static void StepCount_OnImuConfig(const MPU6050_Config_t *cfg)
+{
+    resample_up = 1;
+    resample_down = 1;
+    if (cfg->odr_hz < MPU6050_REF_RATE_HZ) {
+        resample_up = (uint8_t)(MPU6050_REF_RATE_HZ / cfg->odr_hz);
+    } else {
+        resample_down = (uint8_t)(cfg->odr_hz / MPU6050_REF_RATE_HZ);
+    }
+    resample_count = 0;
+    memset(resample_sum, 0, sizeof(resample_sum));
+    resample_has_prev = false;
+    fifo_count = 0;  // 旧配置下读取的帧
+    poll_ticks = 0;
+}
+
+/**
+ * @brief 计步支持的采样配置：输出速率与参考帧率成整数倍（20/40/100/200/1000Hz）
+ */
+bool StepCount_IsImuConfigSupported(const MPU6050_Config_t *cfg)
+{
+    if (!MPU6050_IsConfigValid(cfg)) {
+        return false;
+    }
+    return (cfg->odr_hz <= MPU6050_REF_RATE_HZ) ? (MPU6050_REF_RATE_HZ % cfg->odr_hz == 0)
+                                                : (cfg->odr_hz % MPU6050_REF_RATE_HZ == 0);
+}
+
+/**
+ * @brief 修改 IMU 采样配置：暂停采集独占 I2C，写入后按原采集方式恢复
+ *        运动唤醒模式下直接写入，退出时按新配置恢复采样
+ *
+ * @param cfg 新配置
+ * @return HAL_OK 已生效；HAL_ERROR 不支持的配置或写入失败
+ */
+HAL_StatusTypeDef StepCount_SetImuConfig(const MPU6050_Config_t *cfg)
+{
+    HAL_StatusTypeDef res;
+
+    if (!StepCount_IsImuConfigSupported(cfg)) {
+        return HAL_ERROR;
+    }
+    if (step_idle) {
+        return MPU6050_SetConfig(cfg);
+    }
+    StepCount_Pause();
+    res = MPU6050_SetConfig(cfg);
+    StepCount_Resume();
+    return res;
+}
+
+// 轮询方式：每个 TIM6 周期只读取有限的帧数，限制中断中阻塞 I2C 的时间；
+// 每 50ms 处理一次累积的帧，缓冲区满（读取落后后追赶）时提前处理
+void Timer_Handler_StepCount(void)
+{
+    uint16_t room = MPU6050_FIFO_BATCH_MAX - fifo_count;
+
+    fifo_count += MPU6050_FIFO_Read(&fifo_frames[fifo_count],
+                                    room < STEP_POLL_FRAMES_MAX ? room : STEP_POLL_FRAMES_MAX);
+    if (++poll_ticks < STEP_POLL_BATCH_TICKS && fifo_count < MPU6050_FIFO_BATCH_MAX) {
+        return;
+    }
+    poll_ticks = 0;
+    StepCount_ProcessBatch(fifo_frames, fifo_count);
+    fifo_count = 0;
+}
+
+/**
+ * @brief 选择 IMU 采集方式并启动计步
+ *        DATA_RDY 方式不需要 TIM6，定时器停止
+ */
+void StepCount_Start(MPU6050_AcqMode_t mode)
+{
+    HAL_TIM_Base_Stop_IT(&htim6);
+    MPU6050_SetBatchCallback(StepCount_ProcessBatch);
+    MPU6050_AddConfigListener(StepCount_OnImuConfig);
+    if (MPU6050_SetAcqMode(mode) != HAL_OK) {
+        mode = MPU6050_ACQ_POLL;
+        MPU6050_SetAcqMode(mode);
+    }
+    step_acq_mode = mode;
+    if (mode == MPU6050_ACQ_POLL) {
+        // 定时器已停止，暂停前未凑满一批的帧随之丢弃
+        fifo_count = 0;
+        poll_ticks = 0;
+        // 清除定时器更新中断标志，避免定时器一启动就中断
+        __HAL_TIM_CLEAR_IT(&htim6, TIM_IT_UPDATE);
+        HAL_TIM_Base_Start_IT(&htim6);
+    }
+}
+
+/**
+ * @brief 暂停采集以便任务独占 I2C 配置 MPU6050（停止 TIM6 与 DATA_RDY DMA）
+ *        必须与 StepCount_Resume 成对调用，计步状态保持不变
+ */
+void StepCount_Pause(void)
+{
+    HAL_TIM_Base_Stop_IT(&htim6);
+    MPU6050_SetAcqMode(MPU6050_ACQ_POLL);
+}
+
+/**
+ * @brief 按暂停前的采集方式恢复采集
+ */
+void StepCount_Resume(void)
+{
+    StepCount_Start(step_acq_mode);
+}
+
+// 运动唤醒中断（EXTI 中断上下文），I2C 配置留给任务完成
+static void StepCount_OnMotion(void)
+{
+    step_motion_flag = true;
+}
+
+/**
+ * @brief 计步电源管理任务
+ *        静止超时后停止 TIM6、IMU 进入运动唤醒模式；检测到运动后退出运动唤醒，
+ *        下一个周期（陀螺仪已稳定）恢复原采集方式。
+ *        两种计步算法的状态在静止期间保持不变，步数不受影响；
+ *        跌倒的失重会触发运动唤醒，恢复采集时跌倒检测从等待冲击开始。
+ *        中断只把抽取后的幅值放入活动分类窗口，Goertzel 滤波与分类也在这里完成
+ */
+void Task_StepPower(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    activity_update();
+    if (step_waking) {
+        if (now - step_wake_tick < MPU6050_WAKE_SETTLE_MS) {
+            return;
+        }
+        step_waking = false;
+        step_idle = false;
+        wrist_gesture_resync();  // 静止期间姿态角没有更新
+        FallAlert_Resume();
+        StepCount_Start(step_acq_mode);
+        idle_last_step = g_step;
+        idle_last_active_tick = now;
+        return;
+    }
+    if (step_idle) {
+#if !MPU6050_INT_WIRED
+        // 没有运动中断，每个任务周期读一次 INT_STATUS
+        if (MPU6050_PollMotion()) {
+            step_motion_flag = true;
+        }
+#endif
+        if (!step_motion_flag) {
+            return;
+        }
+        step_motion_flag = false;
+        MPU6050_ExitMotionWake();
+        step_wake_tick = now;
+        step_waking = true;
+        return;
+    }
+
+    if (g_step != idle_last_step || MotionEnergy_IsMoving() || ImuCalib_IsBusy()) {
+        idle_last_step = g_step;
+        idle_last_active_tick = now;
+        return;
+    }
+    if (now - idle_last_active_tick < STEP_IDLE_TIMEOUT_MS) {
+        return;
+    }
+    // 先停止周期读取，避免与下面的配置争用 I2C
+    HAL_TIM_Base_Stop_IT(&htim6);
+    step_motion_flag = false;
+    MPU6050_SetMotionCallback(StepCount_OnMotion);
+    if (MPU6050_EnterMotionWake() != HAL_OK) {
+        // 按唤醒流程恢复，下一个周期重新开始采集
+        MPU6050_ExitMotionWake();
+        step_wake_tick = now;
+        step_waking = true;
+        return;
+    }
+    step_idle = true;
+}
+
+bool StepCount_IsIdle(void)
+{
+    return step_idle;
+}
+
+/**
+ * @brief 最近一次活动分类结果，IMU 处于运动唤醒模式时为静止
+ */
+void StepCount_GetActivity(ActivityResult_t *result)
+{
+    if (step_idle) {
+        memset(result, 0, sizeof(*result));
+        result->e_class = ACTIVITY_STILL;
+        return;
+    }
+    // 分类结果由 Task_StepPower 更新，与读者同在任务上下文
+    activity_get(result);
+}
+
+/**
+ * @brief 切换计步算法，下一批数据开始生效，已累计的步数保留
+ */
+void StepCount_SetEngine(StepEngine_t engine)
+{
+    if (engine < STEP_ENGINE_COUNT) {
+        step_engine_request = engine;
+    }
+}
+
+StepEngine_t StepCount_GetEngine(void)
+{
+    return step_engine_request;
+}
+
+const char *StepCount_GetEngineName(StepEngine_t engine)
+{
+    return (engine < STEP_ENGINE_COUNT) ? step_engine_names[engine] : "?";
+}
+
+/**
+ * @brief 当前步频（步/分钟），仅加速度幅值算法提供，未在行走时为 0
+ */
+uint16_t StepCount_GetCadence(void)
+{
+    if (step_engine != STEP_ENGINE_ACCEL_MAG) {
+        return 0;
+    }
+    return step_accel_cadence(&step_accel);
+}
+
+/**
+ * @brief 取走最近一次抬腕/放下事件（取走后清除）
+ */
+WristEvent_t StepCount_TakeWristEvent(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    WristEvent_t event;
+
+    __disable_irq();
+    event = wrist_event;
+    wrist_event = WRIST_EVENT_NONE;
+    __set_PRIMASK(primask);
+    return event;
+}
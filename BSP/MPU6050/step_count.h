@@ -1,10 +1,45 @@
 #ifndef __STEP_COUNT_H
 #define __STEP_COUNT_H
 
+#include "activity.h"
 #include "mpu6050.h"
+#include "wrist_gesture.h"
 
-extern uint16_t g_step;
+// 计步算法，可在运行时切换
+typedef enum {
+    STEP_ENGINE_GYRO_AXIS = 0,  // 最活跃轴角速度过中线（每批 10 帧取平均，300ms 判定一次）
+    STEP_ENGINE_ACCEL_MAG,      // 加速度幅值自适应峰谷检测，逐帧判定
+    STEP_ENGINE_COUNT
+} StepEngine_t;
+
+#define STEP_ENGINE_DEFAULT STEP_ENGINE_GYRO_AXIS
+
+// 静止超过该时间（无新步且运动能量低于门限）后 IMU 进入运动唤醒模式，TIM6 停止
+#define STEP_IDLE_TIMEOUT_MS 10000
+#define STEP_POWER_TASK_PERIOD_MS 100  // 电源管理任务周期，运动唤醒后最多两个周期恢复采样
+
+// 轮询方式：TIM6 每 10ms 读取一次 FIFO，每次最多 POLL_FRAMES_MAX 帧（144 字节，400kHz 下约 3.3ms），
+// 其余留在 FIFO 中下次读取；凑满 POLL_BATCH_TICKS 次（50ms）后作为一批处理
+#define STEP_POLL_PERIOD_MS 10   // 与 tim.c 中 TIM6 的周期一致
+#define STEP_POLL_FRAMES_MAX 12  // 1kHz 下每 10ms 10 帧，留出追赶余量
+#define STEP_POLL_BATCH_TICKS (50 / STEP_POLL_PERIOD_MS)
+
+extern uint16_t g_step;  // 计步中断递增，允许回绕；当天步数见 StepLog_GetToday
 
 void Timer_Handler_StepCount(void);
+void StepCount_ProcessBatch(const MPU6050_Frame_t *frames, uint16_t n);
+void StepCount_Start(MPU6050_AcqMode_t mode);
+void StepCount_Pause(void);
+void StepCount_Resume(void);
+bool StepCount_IsImuConfigSupported(const MPU6050_Config_t *cfg);
+HAL_StatusTypeDef StepCount_SetImuConfig(const MPU6050_Config_t *cfg);
+void StepCount_SetEngine(StepEngine_t engine);
+StepEngine_t StepCount_GetEngine(void);
+const char *StepCount_GetEngineName(StepEngine_t engine);
+uint16_t StepCount_GetCadence(void);
+bool StepCount_IsIdle(void);
+void StepCount_GetActivity(ActivityResult_t *result);
+WristEvent_t StepCount_TakeWristEvent(void);
+void Task_StepPower(void);
 
 #endif
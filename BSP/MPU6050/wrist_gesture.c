@@ -0,0 +1,191 @@
+#include "wrist_gesture.h"
+
+#include <string.h>
+
+#include "int_math.h"
+
+#define WRIST_GYRO_LSB_PER_DPS 131  // 参考量程 ±250°/s
+#define WRIST_ANGLE_Q 8             // 内部角度 0.01° 再左移 8 位，保留积分的小数部分
+#define WRIST_ANGLE_180 (18000L << WRIST_ANGLE_Q)
+#define WRIST_RAISE_HOLD_FRAMES (WRIST_RAISE_HOLD_MS * WRIST_INPUT_HZ / 1000)
+#define WRIST_DROP_HOLD_FRAMES (WRIST_DROP_HOLD_MS * WRIST_INPUT_HZ / 1000)
+
+static int32_t n_pitch;  // 0.01° (Q8)
+static int32_t n_roll;   // 0.01° (Q8)
+static bool b_synced;    // 角度已由加速度初始化
+static bool b_raised;    // 已报告抬腕，等待放下
+static uint16_t uw_hold;
+static int16_t aw_hist_pitch[WRIST_HISTORY_LEN];  // 0.01°，环形
+static int16_t aw_hist_roll[WRIST_HISTORY_LEN];
+static uint8_t uch_hist_head;
+static uint8_t uch_hist_filled;
+static uint8_t uch_hist_decim;
+
+/**
+ * @brief 整数 atan2，返回 0.01°，范围 -18000 ~ 18000
+ *        atan(r) ≈ 45r + 15.64r(1-r) (0 <= r <= 1)，最大误差约 0.3°
+ */
+static int32_t wrist_atan2(int32_t n_y, int32_t n_x)
+{
+    uint32_t un_ax = (n_x < 0) ? (uint32_t)-n_x : (uint32_t)n_x;
+    uint32_t un_ay = (n_y < 0) ? (uint32_t)-n_y : (uint32_t)n_y;
+    uint32_t un_r;
+    int32_t n_angle;
+
+    if (un_ax == 0 && un_ay == 0)
+        return 0;
+    // 输入不超过 2^16，比值 (Q15) 计算不会溢出
+    if (un_ax >= un_ay) {
+        un_r = (un_ay << 15) / un_ax;
+        n_angle = (int32_t)((4500 * un_r + ((1564 * ((un_r * (32768 - un_r)) >> 15)))) >> 15);
+    } else {
+        un_r = (un_ax << 15) / un_ay;
+        n_angle =
+            9000 - (int32_t)((4500 * un_r + ((1564 * ((un_r * (32768 - un_r)) >> 15)))) >> 15);
+    }
+    if (n_x < 0)
+        n_angle = 18000 - n_angle;
+    return (n_y < 0) ? -n_angle : n_angle;
+}
+
+// 角度差折算到 ±180°
+static int32_t wrist_wrap(int32_t n_angle)
+{
+    if (n_angle > WRIST_ANGLE_180)
+        n_angle -= 2 * WRIST_ANGLE_180;
+    else if (n_angle < -WRIST_ANGLE_180)
+        n_angle += 2 * WRIST_ANGLE_180;
+    return n_angle;
+}
+
+static bool wrist_in_view(int32_t n_p, int32_t n_r)
+{
+    return n_p <= WRIST_VIEW_PITCH_MAX && n_p >= -WRIST_VIEW_PITCH_MAX &&
+           n_r <= WRIST_VIEW_ROLL_MAX && n_r >= -WRIST_VIEW_ROLL_MAX;
+}
+
+/**
+ * @brief 最近 WRIST_HISTORY_LEN 个记录中是否有在观看姿态之外、且与当前姿态相差足够大的
+ */
+static bool wrist_came_from_away(int32_t n_p, int32_t n_r)
+{
+    for (uint8_t i = 0; i < uch_hist_filled; i++) {
+        int32_t n_dp = n_p - aw_hist_pitch[i];
+        int32_t n_dr = n_r - aw_hist_roll[i];
+        if (n_dr > 18000)
+            n_dr -= 36000;
+        else if (n_dr < -18000)
+            n_dr += 36000;
+        if (wrist_in_view(aw_hist_pitch[i], aw_hist_roll[i]))
+            continue;
+        if (n_dp >= WRIST_RAISE_MIN_DELTA || n_dp <= -WRIST_RAISE_MIN_DELTA ||
+            n_dr >= WRIST_RAISE_MIN_DELTA || n_dr <= -WRIST_RAISE_MIN_DELTA)
+            return true;
+    }
+    return false;
+}
+
+void wrist_gesture_reset(void)
+{
+    n_pitch = 0;
+    n_roll = 0;
+    b_synced = false;
+    b_raised = false;
+    uw_hold = 0;
+    memset(aw_hist_pitch, 0, sizeof(aw_hist_pitch));
+    memset(aw_hist_roll, 0, sizeof(aw_hist_roll));
+    uch_hist_head = 0;
+    uch_hist_filled = 0;
+    uch_hist_decim = 0;
+}
+
+/**
+ * @brief 采样中断后恢复输入时调用：下一帧直接由加速度确定姿态，姿态记录保留
+ *        （中断前手臂下垂、恢复后已在观看姿态，仍能判定为抬腕）
+ */
+void wrist_gesture_resync(void)
+{
+    b_synced = false;
+}
+
+/**
+ * @brief 输入一帧原始数据（200Hz）
+ *
+ * @param w_ax X 轴加速度原始值
+ * @param w_ay Y 轴加速度原始值
+ * @param w_az Z 轴加速度原始值
+ * @param w_gx X 轴角速度原始值（横滚）
+ * @param w_gy Y 轴角速度原始值（俯仰）
+ * @return 本帧产生的手势事件
+ */
+WristEvent_t wrist_gesture_push(int16_t w_ax, int16_t w_ay, int16_t w_az, int16_t w_gx,
+                                int16_t w_gy)
+{
+    int32_t n_acc_pitch, n_acc_roll, n_p, n_r;
+    uint32_t un_yz;
+    bool b_steady, b_view;
+
+    un_yz = isqrt32(mag_sq2(w_ay, w_az));
+    n_acc_pitch = wrist_atan2(-(int32_t)w_ax, (int32_t)un_yz) << WRIST_ANGLE_Q;
+    n_acc_roll = wrist_atan2(w_ay, w_az) << WRIST_ANGLE_Q;
+
+    if (!b_synced) {
+        n_pitch = n_acc_pitch;
+        n_roll = n_acc_roll;
+        b_synced = true;
+    } else {
+        // 陀螺仪积分：raw * 100 / 131 (0.01°/s) / 200Hz，Q8
+        n_pitch += (int32_t)w_gy * (100 << WRIST_ANGLE_Q) /
+                   (WRIST_GYRO_LSB_PER_DPS * WRIST_INPUT_HZ);
+        n_roll += (int32_t)w_gx * (100 << WRIST_ANGLE_Q) /
+                  (WRIST_GYRO_LSB_PER_DPS * WRIST_INPUT_HZ);
+        n_roll = wrist_wrap(n_roll);
+        // 加速度修正漂移
+        n_pitch += (n_acc_pitch - n_pitch) >> WRIST_CF_SHIFT;
+        n_roll = wrist_wrap(n_roll + (wrist_wrap(n_acc_roll - n_roll) >> WRIST_CF_SHIFT));
+    }
+    n_p = n_pitch >> WRIST_ANGLE_Q;
+    n_r = n_roll >> WRIST_ANGLE_Q;
+
+    if (++uch_hist_decim >= WRIST_HISTORY_DECIM) {
+        uch_hist_decim = 0;
+        aw_hist_pitch[uch_hist_head] = (int16_t)n_p;
+        aw_hist_roll[uch_hist_head] = (int16_t)n_r;
+        uch_hist_head = (uch_hist_head + 1) % WRIST_HISTORY_LEN;
+        if (uch_hist_filled < WRIST_HISTORY_LEN)
+            uch_hist_filled++;
+    }
+
+    b_view = wrist_in_view(n_p, n_r);
+    if (b_raised) {
+        // 放下判定不要求停稳，hold 计离开观看姿态的帧数
+        uw_hold = b_view ? 0 : uw_hold + 1;
+        if (uw_hold < WRIST_DROP_HOLD_FRAMES)
+            return WRIST_EVENT_NONE;
+        uw_hold = 0;
+        b_raised = false;
+        return WRIST_EVENT_DROP;
+    }
+
+    b_steady = w_gx < WRIST_STEADY_DPS * WRIST_GYRO_LSB_PER_DPS &&
+               w_gx > -WRIST_STEADY_DPS * WRIST_GYRO_LSB_PER_DPS &&
+               w_gy < WRIST_STEADY_DPS * WRIST_GYRO_LSB_PER_DPS &&
+               w_gy > -WRIST_STEADY_DPS * WRIST_GYRO_LSB_PER_DPS;
+    uw_hold = (b_view && b_steady) ? uw_hold + 1 : 0;
+    if (uw_hold < WRIST_RAISE_HOLD_FRAMES)
+        return WRIST_EVENT_NONE;
+    uw_hold = 0;
+    if (!wrist_came_from_away(n_p, n_r))
+        return WRIST_EVENT_NONE;  // 一直在观看姿态（例如放在桌面上），不算抬腕
+    b_raised = true;
+    return WRIST_EVENT_RAISE;
+}
+
+/**
+ * @brief 当前姿态角 (0.01°)
+ */
+void wrist_gesture_get_angles(int16_t *pw_pitch, int16_t *pw_roll)
+{
+    *pw_pitch = (int16_t)(n_pitch >> WRIST_ANGLE_Q);
+    *pw_roll = (int16_t)(n_roll >> WRIST_ANGLE_Q);
+}
@@ -0,0 +1,48 @@
+/**
+ * @file wrist_gesture.h
+ * @author Shiki
+ * @brief Wrist-raise / turn-to-view gesture detection for display wake-up.
+ *        Pitch and roll are tracked with an integer complementary filter: the gyro rate is
+ *        integrated every frame and pulled towards the accelerometer tilt with a time constant
+ *        of about 160 ms. A raise is reported when the wrist settles in the viewing pose
+ *        (display facing up) after having been at least WRIST_RAISE_MIN_DELTA away from it
+ *        within the last WRIST_HISTORY_LEN * 50 ms; a drop when it leaves that pose again.
+ *        Integer arithmetic only, no dependency on the HAL (can be built on the host).
+ * @version 0.1
+ * @date 2025-10-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __WRIST_GESTURE_H
+#define __WRIST_GESTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WRIST_INPUT_HZ 200  // 输入帧率，即 MPU6050 参考帧率
+#define WRIST_CF_SHIFT 5    // 互补滤波加速度修正系数 1/32，时间常数约 160ms
+
+// 观看姿态：屏幕朝上，俯仰角与横滚角都在范围内 (0.01°)
+#define WRIST_VIEW_PITCH_MAX 3500
+#define WRIST_VIEW_ROLL_MAX 4500
+#define WRIST_RAISE_MIN_DELTA 4000  // 进入观看姿态前至少转过 40°
+#define WRIST_STEADY_DPS 40         // 俯仰、横滚角速度都低于该值视为停稳
+#define WRIST_RAISE_HOLD_MS 150     // 在观看姿态停稳该时间后报告抬腕
+#define WRIST_DROP_HOLD_MS 300      // 离开观看姿态该时间后报告放下
+#define WRIST_HISTORY_DECIM 10      // 每 10 帧 (50ms) 记录一次姿态
+#define WRIST_HISTORY_LEN 32        // 回看 1.6s
+
+typedef enum {
+    WRIST_EVENT_NONE = 0,
+    WRIST_EVENT_RAISE,  // 抬腕或翻腕进入观看姿态
+    WRIST_EVENT_DROP    // 离开观看姿态
+} WristEvent_t;
+
+void wrist_gesture_reset(void);
+void wrist_gesture_resync(void);
+WristEvent_t wrist_gesture_push(int16_t w_ax, int16_t w_ay, int16_t w_az, int16_t w_gx,
+                                int16_t w_gy);
+void wrist_gesture_get_angles(int16_t *pw_pitch, int16_t *pw_roll);
+
+#endif
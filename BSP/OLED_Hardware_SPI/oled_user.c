@@ -1,13 +1,16 @@
 #include "oled_user.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "atgm336h.h"
 #include "max30102_user.h"
 #include "mpu6050.h"
 #include "oled_hardware_spi.h"
+#include "sensor_hub.h"
 #include "step_count.h"
+#include "step_log.h"
 #include "task_scheduler.h"
 #include "user_data.h"
 
@@ -15,10 +18,16 @@
 #define OLED_MAX_STR_LEN 16   // 最大显示字符数
 #define OLED_STR_BUF_SIZE 17  // 缓冲区大小 (包含'\0')
 
+#define OLED_TEMP_MAX_AGE_MS 1000  // 待机界面温度缓存的最大年龄
+
 OLED_MainInterface g_curr_main_interface = OLED_STANDBY;
 RTC_DateTypeDef g_rtc_date;
 RTC_TimeTypeDef g_rtc_time;
 
+static bool oled_on = true;  // 上电时 OLED_Init 已开显示
+static uint32_t oled_active_tick;
+static uint32_t oled_timeout_ms = OLED_ON_TIMEOUT_MS;
+
 static void OLED_STANDBY_Display(void) {
     OLED_ShowString(0, 0, (uint8_t*)"< BLE Bracelet >", 16);
     // 读取时间和日期
@@ -38,8 +47,15 @@ static void OLED_STANDBY_Display(void) {
     OLED_ShowString(0, 4, (uint8_t*)time_str, 16);
     // 显示当前温度
     char temp_str[16] = {0};
-    MPU6050_Read_All();
-    snprintf(temp_str, sizeof(temp_str), "Temp:%.2f C", g_temp);
+    int32_t temp_centi;
+    SensorSample_t sample;
+    // 温度变化缓慢，每秒最多读取一次总线，其余刷新使用缓存
+    if (!SensorHub_Read(SENSOR_CH_IMU_TEMP, OLED_TEMP_MAX_AGE_MS, &sample)) {
+        return;
+    }
+    temp_centi = MPU6050_TEMP_TO_CENTI_C(sample.v[0]);
+    snprintf(temp_str, sizeof(temp_str), "Temp:%s%ld.%02ld C", (temp_centi < 0) ? "-" : "",
+             labs(temp_centi) / 100, labs(temp_centi) % 100);
     OLED_ShowString(0, 6, (uint8_t*)temp_str, 16);
 }
 
@@ -50,6 +66,14 @@ static void OLED_MAX30102_Display(void) {
     if (MAX30102_IsVaid()) {
         snprintf(blood_str, sizeof(blood_str), "HR:%3d SpO2:%3d", g_heart_rate, g_spo2);
         UserData_UpdateHealth();
+    } else if (MAX30102_GetState() == MAX30102_STATE_DETECT) {
+        snprintf(blood_str, sizeof(blood_str), "Place finger... ");
+    } else if (MAX30102_GetState() == MAX30102_STATE_FILLING) {
+        snprintf(blood_str, sizeof(blood_str), "Measuring %3d%% ", MAX30102_GetFillPercent());
+    } else if (g_ppg_motion) {
+        snprintf(blood_str, sizeof(blood_str), "HR:--- Motion! ");
+    } else if (g_ppg_quality.sqi < PPG_QUALITY_SQI_MIN) {
+        snprintf(blood_str, sizeof(blood_str), "HR:--- Weak sig");
     } else {
         snprintf(blood_str, sizeof(blood_str), "HR:--- SpO2:---");
     }
@@ -66,7 +90,7 @@ static void OLED_StepGPS_Display(void) {
     OLED_ShowString(0, 0, (uint8_t*)"Steps & GPS Data", 16);
     // 显示当前步数
     char step_str[20] = {0};
-    snprintf(step_str, sizeof(step_str), "Steps:%5d", g_step);
+    snprintf(step_str, sizeof(step_str), "Steps:%5lu", (unsigned long)StepLog_GetToday());
     OLED_ShowString(0, 2, (uint8_t*)step_str, 16);
     // 显示GPS信息 (限制字符串长度为OLED_MAX_STR_LEN)
     char gps_utc_str[OLED_STR_BUF_SIZE] = {0};
@@ -105,7 +129,7 @@ static void OLED_TEST_Display(void) {
 #if 0
     OLED_ShowString(0, 0, (uint8_t*)"OLED TEST MODE", 16);
     // 测试MPU6050
-    MPU6050_Read_All();
+    MPU6050_UpdateFloatView();
     char accel_str[20] = {0};
     snprintf(accel_str, sizeof(accel_str), "A:%.2f %.2f %.2f", g_ax, g_ay, g_az);
     OLED_ShowString(0, 2, (uint8_t*)accel_str, 8);
@@ -113,7 +137,7 @@ static void OLED_TEST_Display(void) {
     snprintf(gyro_str, sizeof(gyro_str), "G:%.2f %.2f %.2f", g_gx, g_gy, g_gz);
     OLED_ShowString(0, 3, (uint8_t*)gyro_str, 8);
     char step_str[20] = {0};
-    snprintf(step_str, sizeof(step_str), "Step:%d", g_step);
+    snprintf(step_str, sizeof(step_str), "Step:%lu", (unsigned long)StepLog_GetToday());
     OLED_ShowString(0, 4, (uint8_t*)step_str, 8);
     // 测试MAX30102
     char blood_str[20] = {0};
@@ -198,8 +222,67 @@ void OLED_MoveToNextInterface(void) {
         (OLED_MainInterface)(((uint8_t)g_curr_main_interface + 1) % OLED_MAIN_INTERFACE_COUNT);
     OLED_Clear();
     if (g_curr_main_interface == OLED_MAX30102) {
-        TaskScheduler_ResumeTask("Blood_Measure_Task");
-    } else {
-        TaskScheduler_SuspendTask("Blood_Measure_Task");
+        MAX30102_Resume();
+    } else if (MAX30102_GetState() != MAX30102_STATE_SHUTDOWN) {
+        MAX30102_Suspend();
+    }
+}
+
+/**
+ * @brief 点亮屏幕并重新开始亮屏计时，已亮时只延长计时
+ */
+void OLED_Wake(void) {
+    oled_active_tick = HAL_GetTick();
+    oled_timeout_ms = OLED_ON_TIMEOUT_MS;
+    if (oled_on) {
+        return;
+    }
+    oled_on = true;
+    OLED_Display_On();
+    Task_OLED_Update();  // 立即刷新，避免先显示熄屏前的旧内容
+    TaskScheduler_ResumeTask("OLED_Task");
+}
+
+// 熄屏：SSD1306 关显示并关电荷泵，刷新任务挂起，不再占用 SPI
+static void OLED_Sleep(void) {
+    oled_on = false;
+    TaskScheduler_SuspendTask("OLED_Task");
+    OLED_Display_Off();
+}
+
+bool OLED_IsOn(void) {
+    return oled_on;
+}
+
+/**
+ * @brief 亮屏管理任务：处理抬腕/放下手势与亮屏超时
+ */
+void Task_OLED_Power(void) {
+    uint32_t now = HAL_GetTick();
+    WristEvent_t event = StepCount_TakeWristEvent();
+
+    if (event == WRIST_EVENT_RAISE) {
+        OLED_Wake();
+        return;
+    }
+    if (!oled_on) {
+        return;
+    }
+    // 手指在传感器上（测量中）时界面是唯一的反馈，保持亮屏
+    if (g_curr_main_interface == OLED_MAX30102 &&
+        (MAX30102_GetState() == MAX30102_STATE_FILLING ||
+         MAX30102_GetState() == MAX30102_STATE_MEASURING)) {
+        oled_active_tick = now;
+        return;
+    }
+    if (now - oled_active_tick >= oled_timeout_ms) {
+        OLED_Sleep();
+        return;
+    }
+    // 放下手腕：剩余亮屏时间缩短到 OLED_DROP_TIMEOUT_MS
+    if (event == WRIST_EVENT_DROP &&
+        oled_timeout_ms - (now - oled_active_tick) > OLED_DROP_TIMEOUT_MS) {
+        oled_active_tick = now;
+        oled_timeout_ms = OLED_DROP_TIMEOUT_MS;
     }
 }
@@ -1,10 +1,17 @@
 #ifndef __OLED_USER_H
 #define __OLED_USER_H
 
+#include <stdbool.h>
+
 #include "rtc.h"
 
 #define OLED_MAIN_INTERFACE_COUNT 3
 
+// 亮屏管理：抬腕或按键点亮，超时或放下手腕后熄屏，熄屏期间刷新任务挂起
+#define OLED_ON_TIMEOUT_MS 5000        // 点亮后无操作的亮屏时间
+#define OLED_DROP_TIMEOUT_MS 1000      // 放下手腕后最多再亮该时间
+#define OLED_POWER_TASK_PERIOD_MS 50   // 亮屏管理任务周期
+
 typedef enum { OLED_STANDBY = 0, OLED_MAX30102, OLED_STEP_GPS, OLED_TEST } OLED_MainInterface;
 
 extern OLED_MainInterface g_curr_main_interface;
@@ -13,5 +20,8 @@ extern RTC_TimeTypeDef g_rtc_time;
 
 void Task_OLED_Update(void);
 void OLED_MoveToNextInterface(void);
+void OLED_Wake(void);
+bool OLED_IsOn(void);
+void Task_OLED_Power(void);
 
 #endif
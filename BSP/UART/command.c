@@ -2,14 +2,18 @@
 
 // 指令的最小长度，修改该值以适配不同协议格式的长度
 #define COMMAND_MIN_LENGTH 4
-// 循环缓冲区大小，增大该值以降低缓冲区溢出的概率
-#define BUFFER_SIZE 220
-// 循环缓冲区
+// 循环缓冲区大小，必须为 2 的幂。DMA 覆盖未读数据前解析任务必须读走，
+// 115200bps 下 256 字节约 22ms，解析任务 10ms 运行一次
+#define BUFFER_SIZE 256
+#define BUFFER_MASK (BUFFER_SIZE - 1)
+// 循环缓冲区，由 UART DMA 以循环模式写入
 static uint8_t buffer[BUFFER_SIZE];
+// 跨越缓冲区末尾的指令拼接到这里，其余指令直接在缓冲区中读取
+static uint8_t frame[0xFF];
 // 循环缓冲区读索引
-static uint8_t read_index = 0;
-// 循环缓冲区写索引
-static uint8_t write_index = 0;
+static uint16_t read_index = 0;
+// 写入缓冲区的 UART
+static UART_HandleTypeDef *rx_huart;
 
 /**
  * @brief 增加读索引
@@ -17,106 +21,61 @@ static uint8_t write_index = 0;
  */
 static void Command_AddReadIndex(uint8_t length)
 {
-    read_index += length;
-    read_index %= BUFFER_SIZE;
+    read_index = (read_index + length) & BUFFER_MASK;
 }
 
 /**
  * @brief 读取第i位数据 超过缓存区长度自动循环
  * @param i 要读取的数据索引
  */
-static uint8_t Command_Read(uint8_t i)
+static uint8_t Command_Read(uint16_t i)
 {
-    uint8_t index = i % BUFFER_SIZE;
-    return buffer[index];
+    return buffer[i & BUFFER_MASK];
 }
 
 /**
- * @brief 计算未处理的数据长度
+ * @brief 计算未处理的数据长度，写索引由 DMA 剩余传输数得到
  * @return 未处理的数据长度
- * @retval 0 缓冲区为空
- * @retval 1~BUFFER_SIZE-1 未处理的数据长度
- * @retval BUFFER_SIZE 缓冲区已满
+ * @retval 0 缓冲区为空（DMA 恰好写满一圈时也为 0，此时数据已被覆盖）
  */
-static uint8_t Command_GetLength()
+static uint16_t Command_GetLength(void)
 {
-    // 读索引等于写索引时，缓冲区为空
-    if (read_index == write_index) {
-        return 0;
-    }
-    // 如果缓冲区已满,返回BUFFER_SIZE
-    if ((write_index + 1) % BUFFER_SIZE == read_index) {
-        return BUFFER_SIZE - 1;  // 实际可用空间比BUFFER_SIZE少1，避免满空无法区分
-    }
-    // 如果缓冲区未满,返回未处理的数据长度
-    if (read_index <= write_index) {
-        return write_index - read_index;
-    } else {
-        return BUFFER_SIZE - read_index + write_index;
-    }
-}
-// uint8_t Command_GetLength() {
-//   // 读索引等于写索引时，缓冲区为空
-//   if (read_index == write_index) {
-//     return 0;
-//   }
-//   // 如果缓冲区已满,返回BUFFER_SIZE
-//   if (write_index + 1 == read_index || (write_index == BUFFER_SIZE - 1 && read_index == 0)) {
-//     return BUFFER_SIZE;
-//   }
-//   // 如果缓冲区未满,返回未处理的数据长度
-//   if (read_index <= write_index) {
-//     return write_index - read_index;
-//   } else {
-//     return BUFFER_SIZE - read_index + write_index;
-//   }
-// }
+    // 剩余传输数从 BUFFER_SIZE 递减，到 0 时自动重装
+    uint16_t write_index = (BUFFER_SIZE - __HAL_DMA_GET_COUNTER(rx_huart->hdmarx)) & BUFFER_MASK;
 
-/**
- * @brief 计算缓冲区剩余空间
- * @return 剩余空间
- * @retval 0 缓冲区已满
- * @retval 1~BUFFER_SIZE-1 剩余空间
- * @retval BUFFER_SIZE 缓冲区为空
- */
-static uint8_t Command_GetRemain()
-{
-    return BUFFER_SIZE - Command_GetLength();
+    return (write_index - read_index) & BUFFER_MASK;
 }
 
 /**
- * @brief 向缓冲区写入数据
- * @param data 要写入的数据指针
- * @param length 要写入的数据长度
- * @return 写入的数据长度
+ * @brief 以循环 DMA 开始接收，出错停止后再次调用即可恢复
+ * @param huart 指令所在的 UART，DMA 接收需配置为循环模式
+ * @return HAL_OK 已开始接收
  */
-uint8_t Command_Write(uint8_t *data, uint8_t length)
+HAL_StatusTypeDef Command_StartReceive(UART_HandleTypeDef *huart)
 {
-    // 如果缓冲区不足 则不写入数据 返回0
-    if (Command_GetRemain() < length) {
-        return 0;
-    }
-    // 使用memcpy函数将数据写入缓冲区
-    if (write_index + length < BUFFER_SIZE) {
-        memcpy(buffer + write_index, data, length);
-        write_index += length;
-    } else {
-        uint8_t first_length = BUFFER_SIZE - write_index;
-        memcpy(buffer + write_index, data, first_length);
-        memcpy(buffer, data + first_length, length - first_length);
-        write_index = length - first_length;
+    HAL_StatusTypeDef status;
+
+    rx_huart = huart;
+    read_index = 0;  // 重新开始后 DMA 从缓冲区起始写入
+    status = HAL_UART_Receive_DMA(huart, buffer, BUFFER_SIZE);
+    if (status == HAL_OK) {
+        // 解析任务轮询写索引，不需要 DMA 过半/完成中断
+        __HAL_DMA_DISABLE_IT(huart->hdmarx, DMA_IT_HT | DMA_IT_TC);
     }
-    return length;
+    return status;
 }
 
 /**
  * @brief 尝试获取一条指令，重写该函数以适配指定协议格式
- * @param command 指令存放指针
+ * @param command 返回指令的起始地址，在下次调用本函数之前有效（DMA 写满一圈之前）
  * @return 获取的指令长度
  * @retval 0 没有获取到指令
  */
-uint8_t Command_GetCommand(uint8_t *command)
+uint8_t Command_GetCommand(const uint8_t **command)
 {
+    if (rx_huart == NULL) {
+        return 0;
+    }
     // 寻找完整指令
     while (1) {
         // 如果缓冲区长度小于COMMAND_MIN_LENGTH 则不可能有完整的指令
@@ -128,8 +87,13 @@ uint8_t Command_GetCommand(uint8_t *command)
             Command_AddReadIndex(1);
             continue;
         }
-        // 如果缓冲区长度小于指令长度 则不可能有完整的指令
+        // 长度字段小于最小长度 则不是包头 跳过
         uint8_t length = Command_Read(read_index + 1);
+        if (length < COMMAND_MIN_LENGTH) {
+            Command_AddReadIndex(1);
+            continue;
+        }
+        // 如果缓冲区长度小于指令长度 则不可能有完整的指令
         if (Command_GetLength() < length) {
             return 0;
         }
@@ -142,9 +106,14 @@ uint8_t Command_GetCommand(uint8_t *command)
             Command_AddReadIndex(1);
             continue;
         }
-        // 如果找到完整指令 则将指令写入command 返回指令长度
-        for (uint8_t i = 0; i < length; i++) {
-            command[i] = Command_Read(read_index + i);
+        // 如果找到完整指令 连续存放时直接返回缓冲区中的地址 跨越末尾时拼接后返回
+        if (read_index + length <= BUFFER_SIZE) {
+            *command = &buffer[read_index];
+        } else {
+            for (uint8_t i = 0; i < length; i++) {
+                frame[i] = Command_Read(read_index + i);
+            }
+            *command = frame;
         }
         Command_AddReadIndex(length);
         return length;
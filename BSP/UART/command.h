@@ -2,6 +2,8 @@
  * @file command.h
  * @author Shiki
  * @brief UART Command, protocol format is 0xAA + length + data + checksum
+ *        The UART DMA writes into the ring buffer in circular mode; the parser reads it in
+ *        place, taking the write index from the DMA transfer counter.
  * @version 0.1
  * @date 2025-07-13
  * 
@@ -14,7 +16,7 @@
 #include "main.h"
 #include <string.h>
 
-uint8_t Command_Write(uint8_t *data, uint8_t length);
-uint8_t Command_GetCommand(uint8_t *command);
+HAL_StatusTypeDef Command_StartReceive(UART_HandleTypeDef *huart);
+uint8_t Command_GetCommand(const uint8_t **command);
 
 #endif
\ No newline at end of file
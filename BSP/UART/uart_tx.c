@@ -0,0 +1,338 @@
+#include "uart_tx.h"
+
+#include <string.h>
+
+#define UART_TX_MASK (UART_TX_BUFFER_SIZE - 1)
+
+static UART_HandleTypeDef *tx_huart;
+static uint8_t tx_buffer[UART_TX_BUFFER_SIZE];
+static uint8_t urgent_frame[UART_TX_URGENT_SIZE];
+// 正在发送的普通数据复制到这里，环形缓冲区中只剩未发送的数据，覆盖策略可以直接丢弃最旧的部分
+static uint8_t tx_chunk[UART_TX_CHUNK_MAX];
+// 索引自由增长，取模后访问缓冲区，两者之差即为未发送的数据量
+static volatile uint32_t tx_head;  // 写入位置
+static volatile uint32_t tx_tail;  // 下一个待发送的位置（已复制到 tx_chunk 的不再占用空间）
+// 尚未发送完的二进制帧的起止位置，紧急帧不插入到帧中间
+static uint32_t frame_start[UART_TX_FRAMES_MAX];
+static uint32_t frame_end[UART_TX_FRAMES_MAX];
+static uint8_t frame_first;
+static uint8_t frame_count;
+static volatile bool tx_busy;      // DMA 正在发送
+static bool tx_urgent;             // 正在发送的是紧急帧
+static uint16_t tx_inflight;       // 正在发送的长度
+static volatile uint8_t urgent_len;  // 等待或正在发送的紧急帧长度，0 表示空闲
+static UartTxFullPolicy_t tx_policy = UART_TX_FULL_POLICY_DEFAULT;
+static UartTxStats_t tx_stats;
+
+static uint32_t UartTx_GetFree(void) {
+    return UART_TX_BUFFER_SIZE - (tx_head - tx_tail);
+}
+
+// 缓冲区能否再写入 len 字节（二进制帧还需要一个帧记录）
+static bool UartTx_HasRoom(uint16_t len, bool frame) {
+    return UartTx_GetFree() >= len && (!frame || frame_count < UART_TX_FRAMES_MAX);
+}
+
+// 发送位置是否在某个二进制帧中间
+static bool UartTx_InFrame(void) {
+    return frame_count != 0 && (int32_t)(tx_tail - frame_start[frame_first]) > 0;
+}
+
+// 移除已全部离开环形缓冲区的帧记录，关中断调用
+static void UartTx_RetireFrames(void) {
+    while (frame_count != 0 && (int32_t)(tx_tail - frame_end[frame_first]) >= 0) {
+        frame_first = (frame_first + 1) % UART_TX_FRAMES_MAX;
+        frame_count--;
+    }
+}
+
+/**
+ * @brief DMA 空闲时开始发送下一段，关中断调用
+ *        紧急帧优先，但不插入到二进制帧中间；普通数据每段不超过 UART_TX_CHUNK_MAX，
+ *        复制到 tx_chunk 后发送，所以紧急帧最多等待一段加上一个二进制帧
+ */
+static void UartTx_Kick(void) {
+    uint32_t pending = tx_head - tx_tail;
+    uint32_t offset = tx_tail & UART_TX_MASK;
+    uint8_t *data;
+    uint16_t len;
+    uint16_t first;
+    bool urgent = false;
+
+    if (tx_busy || tx_huart == NULL) {
+        return;
+    }
+    if (urgent_len != 0 && !UartTx_InFrame()) {
+        data = urgent_frame;
+        len = urgent_len;
+        urgent = true;
+    } else if (pending != 0) {
+        len = (uint16_t)((pending < UART_TX_CHUNK_MAX) ? pending : UART_TX_CHUNK_MAX);
+        first = (len < UART_TX_BUFFER_SIZE - offset) ? len
+                                                     : (uint16_t)(UART_TX_BUFFER_SIZE - offset);
+        memcpy(tx_chunk, &tx_buffer[offset], first);
+        memcpy(tx_chunk + first, tx_buffer, len - first);
+        data = tx_chunk;
+    } else {
+        return;
+    }
+    // UART 被其他发送占用时保持空闲，下次写入或 UartTx_Poll 时重试
+    if (HAL_UART_Transmit_DMA(tx_huart, data, len) != HAL_OK) {
+        return;
+    }
+    __HAL_DMA_DISABLE_IT(tx_huart->hdmatx, DMA_IT_HT);
+    tx_busy = true;
+    tx_urgent = urgent;
+    tx_inflight = len;
+    if (!urgent) {
+        tx_tail += len;
+        UartTx_RetireFrames();
+    }
+}
+
+// 当前一段结束（完成或出错），开始下一段，关中断调用
+static void UartTx_Release(void) {
+    if (tx_urgent) {
+        urgent_len = 0;
+    }
+    tx_busy = false;
+    UartTx_Kick();
+}
+
+// 复制进缓冲区，返回复制的长度，关中断调用
+static uint16_t UartTx_Put(const uint8_t *data, uint16_t len) {
+    uint32_t free = UartTx_GetFree();
+    uint32_t offset = tx_head & UART_TX_MASK;
+    uint16_t first;
+
+    if (len > free) {
+        len = (uint16_t)free;
+    }
+    first = (len < UART_TX_BUFFER_SIZE - offset) ? len : (uint16_t)(UART_TX_BUFFER_SIZE - offset);
+    memcpy(&tx_buffer[offset], data, first);
+    memcpy(tx_buffer, data + first, len - first);
+    tx_head += len;
+    tx_stats.queued += len;
+    if (tx_head - tx_tail > tx_stats.peak) {
+        tx_stats.peak = (uint16_t)(tx_head - tx_tail);
+    }
+    return len;
+}
+
+// 队首可以覆盖的普通数据长度：到第一个已排队的帧为止，正在发送帧的后半部分时为 0，关中断调用
+static uint32_t UartTx_Evictable(void) {
+    uint32_t limit = (frame_count != 0) ? frame_start[frame_first] : tx_head;
+
+    return ((int32_t)(limit - tx_tail) > 0) ? limit - tx_tail : 0;
+}
+
+/**
+ * @brief 覆盖策略：丢弃最旧的未发送普通数据，最多 len 字节，关中断调用
+ * @return 腾出的字节数
+ */
+static uint16_t UartTx_Evict(uint16_t len) {
+    uint32_t avail = UartTx_Evictable();
+
+    if (len > avail) {
+        len = (uint16_t)avail;
+    }
+    tx_tail += len;
+    tx_stats.dropped += len;
+    return len;
+}
+
+static void UartTx_Drop(uint16_t len) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    tx_stats.dropped += len;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 缓冲区满时按策略等待 DMA 腾出 len 字节
+ * @return true 空间已足够，false 应丢弃
+ */
+static bool UartTx_WaitSpace(uint16_t len, bool frame) {
+    uint32_t start = HAL_GetTick();
+
+    // 中断中或关中断时等不到 DMA 完成中断
+    if (tx_policy != UART_TX_FULL_BLOCK || __get_IPSR() != 0 || __get_PRIMASK() != 0 ||
+        len > UART_TX_BUFFER_SIZE) {
+        return false;
+    }
+    tx_stats.blocked++;
+    while (!UartTx_HasRoom(len, frame)) {
+        if (!tx_busy || HAL_GetTick() - start >= UART_TX_BLOCK_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 指定发送使用的 UART（DMA 发送需已配置），此前写入的数据随即开始发送
+ */
+void UartTx_Init(UART_HandleTypeDef *huart) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    tx_huart = huart;
+    UartTx_Kick();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 写入文本等可拆分的数据，放不下的部分按缓冲区满策略处理
+ * @return 写入缓冲区的长度
+ */
+uint16_t UartTx_Write(const uint8_t *data, uint16_t len) {
+    uint16_t done = 0;
+
+    while (done < len) {
+        uint32_t primask = __get_PRIMASK();
+        uint16_t evicted = 0;
+
+        __disable_irq();
+        done += UartTx_Put(data + done, len - done);
+        if (done < len && tx_policy == UART_TX_FULL_OVERWRITE) {
+            evicted = UartTx_Evict(len - done);
+        }
+        UartTx_Kick();
+        __set_PRIMASK(primask);
+        if (evicted != 0) {
+            continue;
+        }
+        if (done < len && !UartTx_WaitSpace(1, false)) {
+            UartTx_Drop(len - done);
+            break;
+        }
+    }
+    return done;
+}
+
+/**
+ * @brief 写入一帧二进制数据，整帧写入或整帧丢弃，紧急帧不会插入到帧中间
+ * @return true 已写入
+ */
+bool UartTx_WriteFrame(const uint8_t *frame, uint16_t len) {
+    do {
+        uint32_t primask = __get_PRIMASK();
+
+        __disable_irq();
+        // 覆盖策略：只有腾出后放得下整帧时才丢弃旧的普通数据
+        if (tx_policy == UART_TX_FULL_OVERWRITE && frame_count < UART_TX_FRAMES_MAX &&
+            UartTx_GetFree() < len && UartTx_GetFree() + UartTx_Evictable() >= len) {
+            UartTx_Evict((uint16_t)(len - UartTx_GetFree()));
+        }
+        if (UartTx_HasRoom(len, true)) {
+            uint8_t slot = (frame_first + frame_count) % UART_TX_FRAMES_MAX;
+            frame_start[slot] = tx_head;
+            UartTx_Put(frame, len);
+            frame_end[slot] = tx_head;
+            frame_count++;
+            UartTx_Kick();
+            __set_PRIMASK(primask);
+            return true;
+        }
+        __set_PRIMASK(primask);
+    } while (UartTx_WaitSpace(len, true));
+    UartTx_Drop(len);
+    return false;
+}
+
+/**
+ * @brief 写入紧急帧（告警），可在中断中调用。在下一个段边界发送，排在已写入的数据之前
+ * @return false 上一紧急帧尚未发送完或帧过长，由调用者稍后重试
+ */
+bool UartTx_WriteUrgent(const uint8_t *frame, uint8_t len) {
+    uint32_t primask = __get_PRIMASK();
+    bool ok = false;
+
+    if (len == 0 || len > UART_TX_URGENT_SIZE) {
+        return false;
+    }
+    __disable_irq();
+    if (urgent_len == 0) {
+        memcpy(urgent_frame, frame, len);
+        urgent_len = len;
+        tx_stats.queued += len;
+        UartTx_Kick();
+        ok = true;
+    }
+    __set_PRIMASK(primask);
+    return ok;
+}
+
+/**
+ * @brief 队列未在发送时重新开始发送（DMA 启动时 UART 忙会使队列停住），可在中断中调用
+ */
+void UartTx_Poll(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    UartTx_Kick();
+    __set_PRIMASK(primask);
+}
+
+void UartTx_SetFullPolicy(UartTxFullPolicy_t policy) {
+    if (policy < UART_TX_FULL_POLICY_COUNT) {
+        tx_policy = policy;
+    }
+}
+
+UartTxFullPolicy_t UartTx_GetFullPolicy(void) {
+    return tx_policy;
+}
+
+void UartTx_GetStats(UartTxStats_t *stats) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = tx_stats;
+    __set_PRIMASK(primask);
+}
+
+void UartTx_ClearStats(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memset(&tx_stats, 0, sizeof(tx_stats));
+    tx_stats.peak = (uint16_t)(tx_head - tx_tail);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 在 HAL_UART_TxCpltCallback 中调用：一段发送完成，接着发送下一段
+ */
+void UartTx_TxCpltCallback(UART_HandleTypeDef *huart) {
+    uint32_t primask = __get_PRIMASK();
+
+    if (huart != tx_huart) {
+        return;
+    }
+    __disable_irq();
+    if (tx_busy) {
+        tx_stats.sent += tx_inflight;
+        UartTx_Release();
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 在 HAL_UART_ErrorCallback 中调用：DMA 发送出错时 HAL 已结束发送，该段计为丢弃
+ */
+void UartTx_ErrorCallback(UART_HandleTypeDef *huart) {
+    uint32_t primask = __get_PRIMASK();
+
+    // 接收出错时发送不受影响，gState 仍为忙
+    if (huart != tx_huart || huart->gState != HAL_UART_STATE_READY) {
+        return;
+    }
+    __disable_irq();
+    if (tx_busy) {
+        tx_stats.dropped += tx_inflight;
+        UartTx_Release();
+    }
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file uart_tx.h
+ * @author Shiki
+ * @brief Non-blocking UART transmit queue drained by chained DMA transfers.
+ *        Writers copy into a ring buffer and return; each DMA transfer-complete interrupt
+ *        starts the next chunk. Binary frames are queued whole or not at all, and an urgent
+ *        frame (alert) is sent ahead of the queued data at the next chunk boundary that is
+ *        not inside a binary frame. Each chunk is copied out of the ring before it is sent,
+ *        so the ring only holds unsent data. When the ring is full, writers drop the new data
+ *        by default, so printf never stalls the task loop. Command 0x0D selects the other
+ *        policies: block (wait for the DMA to free space, only in thread mode, with a
+ *        timeout) or overwrite (discard the oldest unsent text, never part of a queued
+ *        binary frame, and drop the new data only if that is not enough).
+ *        If the UART is still busy with another transfer when a chunk should start, the
+ *        queue waits for the next write or for UartTx_Poll(), which the receive task and
+ *        the UART error callback call.
+ * @version 0.1
+ * @date 2025-10-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __UART_TX_H
+#define __UART_TX_H
+
+#include <stdbool.h>
+
+#include "main.h"
+
+#define UART_TX_BUFFER_SIZE 1024    // 发送环形缓冲区，必须为 2 的幂
+#define UART_TX_CHUNK_MAX 64        // 单次 DMA 长度上限，决定紧急帧的最大等待（115200bps 约 5.6ms）
+#define UART_TX_URGENT_SIZE 32      // 紧急帧长度上限
+#define UART_TX_FRAMES_MAX 16       // 缓冲区中最多记录的二进制帧数，超过时与缓冲区满同样处理
+#define UART_TX_BLOCK_TIMEOUT_MS 100  // 阻塞策略下等待空间的最长时间，超时后丢弃
+
+// 缓冲区满时的处理
+typedef enum {
+    UART_TX_FULL_DROP = 0,  // 丢弃放不下的数据
+    UART_TX_FULL_BLOCK,     // 等待 DMA 腾出空间；中断中或关中断时仍然丢弃
+    UART_TX_FULL_OVERWRITE, // 丢弃最旧的未发送文本（不覆盖二进制帧），仍放不下时丢弃新数据
+    UART_TX_FULL_POLICY_COUNT
+} UartTxFullPolicy_t;
+
+#define UART_TX_FULL_POLICY_DEFAULT UART_TX_FULL_DROP
+
+typedef struct {
+    uint32_t queued;   // 写入缓冲区的字节数（含紧急帧）
+    uint32_t sent;     // DMA 发送完成的字节数
+    uint32_t dropped;  // 丢弃的字节数（含覆盖策略丢弃的旧数据）
+    uint32_t blocked;  // 写入者等待空间的次数
+    uint16_t peak;     // 缓冲区最大占用
+} UartTxStats_t;
+
+void UartTx_Init(UART_HandleTypeDef *huart);
+uint16_t UartTx_Write(const uint8_t *data, uint16_t len);
+bool UartTx_WriteFrame(const uint8_t *frame, uint16_t len);
+bool UartTx_WriteUrgent(const uint8_t *frame, uint8_t len);
+void UartTx_Poll(void);
+void UartTx_SetFullPolicy(UartTxFullPolicy_t policy);
+UartTxFullPolicy_t UartTx_GetFullPolicy(void);
+void UartTx_GetStats(UartTxStats_t *stats);
+void UartTx_ClearStats(void);
+void UartTx_TxCpltCallback(UART_HandleTypeDef *huart);
+void UartTx_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif
@@ -1,31 +1,86 @@
 #include "uart_user.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "command.h"
+#include "fall_alert.h"
+#include "imu_calib.h"
+#include "max30102_agc.h"
+#include "max30102_user.h"
 #include "mpu6050.h"
+#include "ppg_hrv.h"
+#include "sensor_hub.h"
 #include "task_scheduler.h"
+#include "uart_tx.h"
 #include "usart.h"
 #include "user_data.h"
 #include "user_init.h"
 #include "step_count.h"
+#include "step_log.h"
 #include "atgm336h.h"
 
 typedef enum {
     COMMAND_TEMPERATURE = 0x01,
     COMMAND_HEALTH = 0x02,
-    COMMAND_STEP_COUNT = 0x03,
+    COMMAND_STEP_COUNT = 0x03,  // 参数(可选): 计步算法编号
     COMMAND_GPS = 0x04,
+    COMMAND_HR_ENGINE = 0x05,   // 参数(可选): 引擎编号；0xFF: 对比所有引擎；0xFE: 对比 flash/SRAM
+    COMMAND_PPG_AGC = 0x06,     // 参数(可选): 目标直流百分比
+    COMMAND_PPG_DIAG = 0x07,    // 参数(可选): 0x01 清零统计
+    COMMAND_HRV_UPLOAD = 0x08,  // 参数(可选): 0x01 重发环内全部间期；二进制应答
+    COMMAND_IMU_CALIB = 0x09,   // 参数(可选): 0x01 下次静止时重新校准
+    COMMAND_IMU_CONFIG = 0x0A,  // 参数(可选): 输出速率 Hz(u16) + DLPF + 加速度量程 + 陀螺仪量程
+    COMMAND_FALL = BLE_ALERT_FALL,  // 参数(可选): 0x01 清零统计；检测到跌倒时主动上报二进制帧
+    COMMAND_STEP_LOG = 0x0C,        // 二进制应答：当天与最近 7 天的步数
+    COMMAND_UART_TX = 0x0D,         // 参数(可选): 缓冲区满时策略 0 丢弃(默认) / 1 阻塞 / 2 覆盖；0xFF 清零统计
 } CommandCodeType;
 
-uint8_t g_uart_command_buffer[UART_USER_BUFFER_SIZE];  // UART command buffer
+#define TEMP_CACHE_MAX_AGE_MS 10000  // 芯片温度缓存超过该时间改为读取 MPU6050
+#define IMU_TEMP_MAX_AGE_MS 1000     // MPU6050 温度变化缓慢，1s 内的缓存直接使用
+
+// 应答帧与指令帧格式相同：0xAA + 总长度 + 指令码 + 负载 + 校验和
+#define COMMAND_FRAME_HEADER 0xAA
+#define COMMAND_FRAME_OVERHEAD 4
+#define COMMAND_FRAME_MAX_PAYLOAD (0xFF - COMMAND_FRAME_OVERHEAD)
+
+// RR 上传负载：首条序号(u32) + 条数(u8) + RMSSD(u16) + SDNN(u16)，之后每条间期：
+//   int8 差值（与上一条首尾相接且 |差值| <= 127，时刻 = 上一条时刻 + 间期）
+//   或 0x80 + 间期(u16) + 时刻(u32)，每帧第一条总是完整编码；多字节字段均为小端
+#define HRV_UPLOAD_HEADER_SIZE 9
+#define HRV_UPLOAD_ESCAPE 0x80
+#define HRV_UPLOAD_FULL_SIZE 7
+
+// 步数记录负载：年(20xx) + 月 + 日 + 当天步数(u32) + 天数 n(u8) + n 天步数(u32，从昨天起向前)
+#define STEP_LOG_HEADER_SIZE 8
+
+static uint32_t hrv_upload_cursor = 0;  // 下一个待上传间期的序号
 
 static void CommandCode_Temperature(void) {
-    MPU6050_Read_All();
-    printf("Temperature: %.2f C\n", g_temp);
+    SensorSample_t sample;
+    int32_t centi;
+
+    // 优先使用测量期间缓存的 MAX30102 芯片温度，不占用 I2C
+    if (SensorHub_Read(SENSOR_CH_PPG_TEMP, TEMP_CACHE_MAX_AGE_MS, &sample)) {
+        centi = (int32_t)sample.v[0] * 100 / 16;
+        printf("Temperature: %s%ld.%02ld C (sensor, %lu ms ago)\n", (centi < 0) ? "-" : "",
+               (long)(labs(centi) / 100), (long)(labs(centi) % 100),
+               (unsigned long)(HAL_GetTick() - sample.tick));
+        return;
+    }
+    if (!SensorHub_Read(SENSOR_CH_IMU_TEMP, IMU_TEMP_MAX_AGE_MS, &sample)) {
+        printf("Temperature: unavailable\n");
+        return;
+    }
+    centi = MPU6050_TEMP_TO_CENTI_C(sample.v[0]);
+    printf("Temperature: %s%ld.%02ld C\n", (centi < 0) ? "-" : "", (long)(labs(centi) / 100),
+           (long)(labs(centi) % 100));
 }
 
 static void CommandCode_Health(void) {
+    if (g_ppg_motion) {
+        printf("Measurement: motion\n");
+    }
     if (g_newest_user_hr_data.hr == 0 && g_newest_user_hr_data.spo2 == 0) {
         printf("No valid health data available.\n");
         return;
@@ -34,10 +89,27 @@ static void CommandCode_Health(void) {
     printf("Detection Time: %s\n", g_newest_user_hr_data.time);
     printf("Heart Rate: %d bpm, SpO2: %d %%\n", g_newest_user_hr_data.hr,
            g_newest_user_hr_data.spo2);
+    printf("PI: %d.%02d %%, SQI: %d\n", g_newest_user_hr_data.pi / 100,
+           g_newest_user_hr_data.pi % 100, g_newest_user_hr_data.sqi);
+    printf("RR: %d, RMSSD: %d ms, SDNN: %d ms\n", ppg_hrv_count(), ppg_hrv_rmssd(),
+           ppg_hrv_sdnn());
 }
 
-static void CommandCode_StepCount(void) {
-    printf("Current Step Count: %d steps\n", g_step);
+static void CommandCode_StepCount(const uint8_t* args, uint8_t args_len) {
+    ActivityResult_t activity;
+
+    if (args_len >= 1) {
+        StepCount_SetEngine((StepEngine_t)args[0]);
+    }
+    printf("Current Step Count: %lu steps\n", (unsigned long)StepLog_GetToday());
+    printf("Engine: %s, Cadence: %d steps/min\n", StepCount_GetEngineName(StepCount_GetEngine()),
+           StepCount_GetCadence());
+    if (StepCount_IsIdle()) {
+        printf("IMU: motion wake (idle)\n");
+    }
+    StepCount_GetActivity(&activity);
+    printf("Activity: %s, Cadence: %d steps/min, Intensity: %d\n",
+           activity_name(activity.e_class), activity.uw_cadence, activity.uch_intensity);
 }
 
 static void CommandCode_GPS(void) {
@@ -51,7 +123,284 @@ static void CommandCode_GPS(void) {
     }
 }
 
-static void CommandCode_Handle(CommandCodeType cmd_code) {
+static void CommandCode_HrEngine(const uint8_t* args, uint8_t args_len) {
+    if (args_len >= 1 && args[0] == 0xFF) {
+        HrEngineResult_t results[HR_ENGINE_COUNT];
+        PreprocBenchResult_t preproc[PREPROC_IMPL_COUNT];
+        if (!MAX30102_BenchmarkEngines(results)) {
+            printf("No PPG window available.\n");
+            return;
+        }
+        for (uint8_t e = 0; e < HR_ENGINE_COUNT; e++) {
+            printf("%s: HR=%ld(%d) SpO2=%ld(%d) cycles=%lu\n",
+                   MAX30102_GetHrEngineName((HrEngine_t)e), (long)results[e].heart_rate,
+                   results[e].hr_valid, (long)results[e].spo2, results[e].spo2_valid,
+                   (unsigned long)results[e].cycles);
+        }
+        MAX30102_BenchmarkPreprocess(preproc);
+        for (uint8_t i = 0; i < PREPROC_IMPL_COUNT; i++) {
+            printf("Preprocess %s: cycles=%lu\n", preproc[i].name,
+                   (unsigned long)preproc[i].cycles);
+        }
+        return;
+    }
+    if (args_len >= 1 && args[0] == 0xFE) {
+        PlacementBenchResult_t placement[PLACEMENT_FUNC_COUNT];
+        if (!MAX30102_BenchmarkPlacement(placement)) {
+            printf("No PPG window, or RAM copies not built or not linked to SRAM.\n");
+            return;
+        }
+        for (uint8_t i = 0; i < PLACEMENT_FUNC_COUNT; i++) {
+            printf("%s: flash=%lu ram=%lu cycles\n", placement[i].name,
+                   (unsigned long)placement[i].flash_cycles,
+                   (unsigned long)placement[i].ram_cycles);
+        }
+        return;
+    }
+    if (args_len >= 1) {
+        MAX30102_SetHrEngine((HrEngine_t)args[0]);
+    }
+    printf("HR Engine: %s, last estimate: %lu cycles\n",
+           MAX30102_GetHrEngineName(MAX30102_GetHrEngine()),
+           (unsigned long)MAX30102_GetAnalysisCycles());
+}
+
+static void CommandCode_PpgAgc(const uint8_t* args, uint8_t args_len) {
+    MAX30102_AgcStatus_t agc;
+
+    if (args_len >= 1) {
+        MAX30102_AGC_SetTarget(args[0]);
+    }
+    MAX30102_AGC_GetStatus(&agc);
+    printf("AGC target: %d%%, ADC range: %d, steps: %lu\n", agc.target_pct, agc.adc_range,
+           (unsigned long)agc.steps);
+    printf("Red PA: 0x%02X DC: %lu, IR PA: 0x%02X DC: %lu\n", agc.red_pa,
+           (unsigned long)agc.red_dc, agc.ir_pa, (unsigned long)agc.ir_dc);
+}
+
+static void CommandCode_PpgDiag(const uint8_t* args, uint8_t args_len) {
+    const MAX30102_AcqStats_t* stats = MAX30102_GetAcqStats();
+
+    printf("PPG samples: %lu, bursts: %lu, max backlog: %d\n", (unsigned long)stats->samples,
+           (unsigned long)stats->bursts, stats->max_backlog);
+    printf("Overflows: %lu, dropped: %lu, skipped windows: %lu\n",
+           (unsigned long)stats->overflows, (unsigned long)stats->dropped,
+           (unsigned long)stats->skipped_windows);
+    printf("Max read interval: %lu ms, last read: %lu ms, last window: %lu ms\n",
+           (unsigned long)stats->max_interval_ms, (unsigned long)stats->last_tick,
+           (unsigned long)MAX30102_GetWindowTick());
+    if (args_len >= 1 && args[0] == 0x01) {
+        MAX30102_ClearAcqStats();
+    }
+}
+
+/**
+ * @brief 组装一帧：0xAA + 总长度 + 指令码 + 负载 + 校验和
+ *
+ * @param frame 输出，长度至少为 payload_len + COMMAND_FRAME_OVERHEAD
+ * @return 帧长度
+ */
+static uint8_t CommandCode_BuildFrame(uint8_t* frame, uint8_t cmd_code, const uint8_t* payload,
+                                      uint8_t payload_len) {
+    uint8_t len = payload_len + COMMAND_FRAME_OVERHEAD;
+    uint8_t checksum;
+
+    frame[0] = COMMAND_FRAME_HEADER;
+    frame[1] = len;
+    frame[2] = cmd_code;
+    checksum = frame[0] + frame[1] + frame[2];
+    for (uint8_t i = 0; i < payload_len; i++) {
+        frame[3 + i] = payload[i];
+        checksum += payload[i];
+    }
+    frame[len - 1] = checksum;
+    return len;
+}
+
+/**
+ * @brief 发送一帧二进制应答
+ *
+ * @param cmd_code 指令码
+ * @param payload 负载
+ * @param payload_len 负载长度，不超过 COMMAND_FRAME_MAX_PAYLOAD
+ * @return true 已写入发送队列；false 队列已满，整帧被丢弃
+ */
+static bool CommandCode_SendFrame(CommandCodeType cmd_code, const uint8_t* payload,
+                                  uint8_t payload_len) {
+    static uint8_t frame[COMMAND_FRAME_MAX_PAYLOAD + COMMAND_FRAME_OVERHEAD];
+
+    return UartTx_WriteFrame(frame, CommandCode_BuildFrame(frame, cmd_code, payload, payload_len));
+}
+
+static uint8_t* CommandCode_PutU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t* CommandCode_PutU32(uint8_t* p, uint32_t v) {
+    p = CommandCode_PutU16(p, (uint16_t)v);
+    return CommandCode_PutU16(p, (uint16_t)(v >> 16));
+}
+
+/**
+ * @brief 上传 RR 间期：默认只发送上次上传之后的新间期，一帧放不下时分多帧发送
+ *        帧写入发送队列后才前移上传位置；队列满时停止，未发出的间期留到下次上传
+ */
+static void CommandCode_HrvUpload(const uint8_t* args, uint8_t args_len) {
+    static uint8_t payload[COMMAND_FRAME_MAX_PAYLOAD];
+    uint32_t total = ppg_hrv_total();
+    uint16_t count = ppg_hrv_count();
+    uint32_t oldest = total - count;
+    uint16_t rmssd = ppg_hrv_rmssd();
+    uint16_t sdnn = ppg_hrv_sdnn();
+    PpgRrEntry_t entry, prev;
+
+    // 重发全部，或者上次之后环已被覆盖 / 被复位
+    if ((args_len >= 1 && args[0] == 0x01) || hrv_upload_cursor < oldest ||
+        hrv_upload_cursor > total) {
+        hrv_upload_cursor = oldest;
+    }
+
+    do {
+        uint8_t* p = payload + HRV_UPLOAD_HEADER_SIZE;
+        uint32_t cursor = hrv_upload_cursor;
+        uint8_t n = 0;
+
+        while (cursor < total &&
+               (p - payload) + HRV_UPLOAD_FULL_SIZE <= COMMAND_FRAME_MAX_PAYLOAD) {
+            int32_t diff;
+
+            ppg_hrv_get((uint16_t)(cursor - oldest), &entry);
+            diff = (n > 0) ? (int32_t)entry.uw_rr_ms - prev.uw_rr_ms : 0;
+            if (n > 0 && entry.uch_contiguous && diff >= -127 && diff <= 127 &&
+                entry.un_time_ms == prev.un_time_ms + entry.uw_rr_ms) {
+                *p++ = (uint8_t)(int8_t)diff;
+            } else {
+                *p++ = HRV_UPLOAD_ESCAPE;
+                p = CommandCode_PutU16(p, entry.uw_rr_ms);
+                p = CommandCode_PutU32(p, entry.un_time_ms);
+            }
+            prev = entry;
+            n++;
+            cursor++;
+        }
+
+        CommandCode_PutU32(payload, hrv_upload_cursor);
+        payload[4] = n;
+        CommandCode_PutU16(&payload[5], rmssd);
+        CommandCode_PutU16(&payload[7], sdnn);
+        if (!CommandCode_SendFrame(COMMAND_HRV_UPLOAD, payload, (uint8_t)(p - payload))) {
+            printf("HRV upload stopped: TX queue full, %lu intervals left.\n",
+                   (unsigned long)(total - hrv_upload_cursor));
+            return;
+        }
+        hrv_upload_cursor = cursor;
+    } while (hrv_upload_cursor < total);
+}
+
+static void CommandCode_StepLog(void) {
+    uint8_t payload[STEP_LOG_HEADER_SIZE + STEP_LOG_DAYS * 4];
+    uint8_t* p = payload + STEP_LOG_HEADER_SIZE;
+    StepLogSnapshot_t snapshot;
+
+    StepLog_GetSnapshot(&snapshot);
+    payload[0] = snapshot.year;
+    payload[1] = snapshot.month;
+    payload[2] = snapshot.date;
+    CommandCode_PutU32(&payload[3], snapshot.today);
+    payload[7] = snapshot.days;
+    for (uint8_t i = 0; i < snapshot.days; i++) {
+        p = CommandCode_PutU32(p, snapshot.history[i]);
+    }
+    if (!CommandCode_SendFrame(COMMAND_STEP_LOG, payload, (uint8_t)(p - payload))) {
+        printf("Step log not sent: TX queue full.\n");
+    }
+}
+
+static void CommandCode_ImuCalib(const uint8_t* args, uint8_t args_len) {
+    const ImuCalibState_t* state = ImuCalib_GetState();
+
+    if (args_len >= 1 && args[0] == 0x01) {
+        ImuCalib_Request();
+        printf("IMU calibration requested, keep the device still (flat for accel).\n");
+    }
+    printf("IMU Calib: %s%s, %s\n", state->valid ? "valid" : "none",
+           state->accel_calibrated ? " (accel flat)" : "",
+           ImuCalib_IsBusy() ? "collecting" : "idle");
+    printf("Accel offs: %d %d %d\n", state->accel[0], state->accel[1], state->accel[2]);
+    printf("Gyro offs: %d %d %d\n", state->gyro[0], state->gyro[1], state->gyro[2]);
+    if (state->tick != 0) {
+        printf("Last: %lu s ago\n", (unsigned long)((HAL_GetTick() - state->tick) / 1000));
+    }
+}
+
+static void CommandCode_ImuConfig(const uint8_t* args, uint8_t args_len) {
+    static const uint16_t accel_fs_g[] = {2, 4, 8, 16};
+    static const uint16_t gyro_fs_dps[] = {250, 500, 1000, 2000};
+    const MPU6050_Config_t* cfg;
+
+    if (args_len >= 5) {
+        MPU6050_Config_t new_cfg;
+        new_cfg.odr_hz = (uint16_t)(args[0] | args[1] << 8);  // 小端
+        new_cfg.dlpf = (MPU6050_Dlpf_t)args[2];
+        new_cfg.accel_fs = (MPU6050_AccelFs_t)args[3];
+        new_cfg.gyro_fs = (MPU6050_GyroFs_t)args[4];
+        if (StepCount_SetImuConfig(&new_cfg) != HAL_OK) {
+            printf("IMU config rejected (ODR 20/40/100/200/1000 Hz, DLPF <= ODR/2).\n");
+        }
+    }
+    cfg = MPU6050_GetConfig();
+    printf("IMU: ODR %d Hz, DLPF %d Hz, Accel +-%d g, Gyro +-%d dps\n", cfg->odr_hz,
+           MPU6050_GetDlpfHz(cfg->dlpf), accel_fs_g[cfg->accel_fs], gyro_fs_dps[cfg->gyro_fs]);
+}
+
+static void CommandCode_Fall(const uint8_t* args, uint8_t args_len) {
+    FallAlertStatus_t status;
+
+    if (args_len >= 1 && args[0] == 0x01) {
+        FallAlert_ClearStats();
+    }
+    FallAlert_GetStatus(&status);
+    printf("Fall detect: %s, falls: %lu, alerts sent: %lu, retries: %lu%s\n",
+           status.enabled ? "on" : "off (ODR < 100 Hz)", (unsigned long)status.falls,
+           (unsigned long)status.alerts_sent, (unsigned long)status.retries,
+           status.pending ? ", pending" : "");
+    printf("Cycles/sample: max %lu, budget %d, over budget: %lu\n",
+           (unsigned long)status.max_cycles, FALL_ALERT_CYCLE_BUDGET,
+           (unsigned long)status.over_budget);
+    if (status.falls != 0) {
+        printf("Last: %lu s ago, free fall %d ms, impact %d mg\n",
+               (unsigned long)((HAL_GetTick() - status.last_tick) / 1000),
+               status.last.uw_freefall_ms, status.last.uw_impact_mg);
+    }
+}
+
+static void CommandCode_UartTx(const uint8_t* args, uint8_t args_len) {
+    static const char* const policy_names[UART_TX_FULL_POLICY_COUNT] = {"drop", "block",
+                                                                        "overwrite"};
+    UartTxStats_t stats;
+
+    if (args_len >= 1 && args[0] == 0xFF) {
+        UartTx_ClearStats();
+    } else if (args_len >= 1) {
+        UartTx_SetFullPolicy((UartTxFullPolicy_t)args[0]);
+    }
+    UartTx_GetStats(&stats);
+    printf("UART TX: %s when full, peak %d/%d bytes\n", policy_names[UartTx_GetFullPolicy()],
+           stats.peak, UART_TX_BUFFER_SIZE);
+    printf("Queued: %lu, sent: %lu, dropped: %lu, blocked: %lu\n", (unsigned long)stats.queued,
+           (unsigned long)stats.sent, (unsigned long)stats.dropped, (unsigned long)stats.blocked);
+}
+
+/**
+ * @brief 分发指令
+ *
+ * @param cmd_code 指令码
+ * @param args 指令参数（指令码之后、校验和之前的数据）
+ * @param args_len 参数长度
+ */
+static void CommandCode_Handle(CommandCodeType cmd_code, const uint8_t* args, uint8_t args_len) {
     // printf("Processing Command Code: 0x%02X\n", cmd_code);
     switch (cmd_code) {
         case COMMAND_TEMPERATURE:
@@ -61,11 +410,38 @@ static void CommandCode_Handle(CommandCodeType cmd_code) {
             CommandCode_Health();
             break;
         case COMMAND_STEP_COUNT:
-            CommandCode_StepCount();
+            CommandCode_StepCount(args, args_len);
             break;
         case COMMAND_GPS:
             CommandCode_GPS();
             break;
+        case COMMAND_HR_ENGINE:
+            CommandCode_HrEngine(args, args_len);
+            break;
+        case COMMAND_PPG_AGC:
+            CommandCode_PpgAgc(args, args_len);
+            break;
+        case COMMAND_PPG_DIAG:
+            CommandCode_PpgDiag(args, args_len);
+            break;
+        case COMMAND_HRV_UPLOAD:
+            CommandCode_HrvUpload(args, args_len);
+            break;
+        case COMMAND_IMU_CALIB:
+            CommandCode_ImuCalib(args, args_len);
+            break;
+        case COMMAND_IMU_CONFIG:
+            CommandCode_ImuConfig(args, args_len);
+            break;
+        case COMMAND_FALL:
+            CommandCode_Fall(args, args_len);
+            break;
+        case COMMAND_STEP_LOG:
+            CommandCode_StepLog();
+            break;
+        case COMMAND_UART_TX:
+            CommandCode_UartTx(args, args_len);
+            break;
         default:
             break;
     }
@@ -76,41 +452,78 @@ static void CommandCode_Handle(CommandCodeType cmd_code) {
  *
  */
 void Task_BLE_DataReceiveProc(void) {
-    uint8_t command_length = Command_GetCommand(g_uart_command_buffer);
+    const uint8_t* command;
+    uint8_t command_length = Command_GetCommand(&command);
 
+    // 启动 DMA 时 UART 忙而停住的发送队列在这里重试
+    UartTx_Poll();
     // 收到正确格式数据包时的解析
     if (command_length) {
         /*  printf("Received Command: ");
          for (uint8_t i = 0; i < command_length; i++) {
-             printf("0x%02X ", g_uart_command_buffer[i]);
+             printf("0x%02X ", command[i]);
          } */
-        CommandCode_Handle((CommandCodeType)g_uart_command_buffer[2]);
+        // 包格式: 0xAA + 长度 + 指令码 + 参数 + 校验和
+        CommandCode_Handle((CommandCodeType)command[2], &command[3],
+                           (command_length > 4) ? command_length - 4 : 0);
     }
 }
 
-// 中断空闲接收回调函数
-void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size) {
-    // Check if the UART instance is USART2
-    if (huart->Instance == USART2) {
-        Command_Write(g_uart_command_buffer, Size);
-        // Re-enable the reception event
-        HAL_UARTEx_ReceiveToIdle_DMA(huart, g_uart_command_buffer, UART_USER_BUFFER_SIZE);
-        __HAL_DMA_DISABLE_IT(&hdma_usart2_rx, DMA_IT_HT);
+// 接收出错（噪声、帧错误、溢出）时 HAL 会停止 DMA 接收，重新开始
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+    UartTx_ErrorCallback(huart);
+    if (huart->Instance == USART2 && huart->RxState == HAL_UART_STATE_READY) {
+        Command_StartReceive(huart);
     }
+    // 出错结束的发送释放了 UART，停住的队列重新开始
+    UartTx_Poll();
+}
+
+// DMA 发送完成回调，接着发送队列中的下一段
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+    UartTx_TxCpltCallback(huart);
+}
+
+/**
+ * @brief 发送一帧告警，不等待指令任务轮询，可在中断中调用
+ *        作为紧急帧排在已写入的 printf 输出与应答之前，在当前 DMA 段结束后发送
+ *
+ * @param cmd_code 告警指令码 (BLE_ALERT_*)
+ * @param payload 负载
+ * @param payload_len 负载长度，不超过 BLE_ALERT_MAX_PAYLOAD
+ * @return true 已进入发送队列；false 上一帧告警尚未发出，由调用者稍后重试
+ */
+bool BLE_SendAlert(uint8_t cmd_code, const uint8_t* payload, uint8_t payload_len) {
+    uint8_t frame[BLE_ALERT_MAX_PAYLOAD + COMMAND_FRAME_OVERHEAD];
+
+    if (payload_len > BLE_ALERT_MAX_PAYLOAD) {
+        return false;
+    }
+    return UartTx_WriteUrgent(frame, CommandCode_BuildFrame(frame, cmd_code, payload, payload_len));
 }
 
 /**
- * @brief 重定向c库函数printf到DEBUG_USARTx
+ * @brief 重定向c库函数printf到DEBUG_USARTx，写入发送队列后立即返回
  *
  * @param ch
  * @param f
  * @return int
  */
 int fputc(int ch, FILE* f) {
-    HAL_UART_Transmit(&huart2, (uint8_t*)&ch, 1, 0xffff);
+    uint8_t c = (uint8_t)ch;
+
+    UartTx_Write(&c, 1);
     return ch;
 }
 
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+// GCC (newlib) 下 printf 经由 _write 输出；丢弃的部分已计数，返回全部长度以免库函数重试
+int _write(int file, char* ptr, int len) {
+    UartTx_Write((const uint8_t*)ptr, (uint16_t)len);
+    return len;
+}
+#endif
+
 /**
  * @brief: 重定向c库函数getchar,scanf到DEBUG_USARTx
  * @param f
@@ -1,8 +1,8 @@
 /**
  * @file uart_user.h
  * @author Shiki
- * @brief UART user buffer, to start, use HAL_UARTEx_ReceiveToIdle_DMA in user_init.c
- *        to receive data into this buffer.
+ * @brief BLE UART commands, to start, call Command_StartReceive(&huart2) in user_init.c
+ *        to receive into the command ring buffer with circular DMA.
  *        Remember to call Task_BLE_DataReceiveProc() in the task scheduler to process the received data.
  * @version 0.1
  * @date 2025-07-13
@@ -17,14 +17,14 @@
 #include "stdio.h"
 #include "stdbool.h"
 
-#define UART_USER_BUFFER_SIZE 32
-
-extern DMA_HandleTypeDef hdma_usart2_rx;
-
-extern uint8_t g_uart_command_buffer[UART_USER_BUFFER_SIZE]; // UART command buffer
+// 设备主动上报的告警帧，格式与应答帧相同，指令码与对应的查询指令相同
+#define BLE_ALERT_FALL 0x0B        // 跌倒告警
+#define BLE_ALERT_MAX_PAYLOAD 16
 
 // Call this function in the task scheduler to process received UART data
 void Task_BLE_DataReceiveProc(void);
+// 中断中也可调用，上一帧告警尚未发出时返回 false，由调用者稍后重试
+bool BLE_SendAlert(uint8_t cmd_code, const uint8_t *payload, uint8_t payload_len);
 
 
 #endif
@@ -0,0 +1,195 @@
+#include "step_log.h"
+
+#include "rtc.h"
+#include "step_count.h"
+
+#define STEP_LOG_SLOTS (STEP_LOG_DAYS + 1)  // 按日序号取模，当天也占一个槽
+
+#define STEP_LOG_BKP_FLAG RTC_BKP_DR12   // STEP_LOG_BKP_MAGIC，最后写入
+#define STEP_LOG_BKP_DAY RTC_BKP_DR13    // 当天的日序号（2000-01-01 起的天数）
+#define STEP_LOG_BKP_FIRST RTC_BKP_DR14  // 开始记录的日序号，之前的槽无效
+// 每个槽占两个寄存器（低 16 位、高 16 位），DR15 - DR30；F1 的 RTC_BKP_DRx 是连续编号
+#define STEP_LOG_BKP_SLOT(slot) (RTC_BKP_DR15 + 2 * (slot))
+
+static const uint16_t days_before_month[12] = {0,   31,  59,  90,  120, 151,
+                                               181, 212, 243, 273, 304, 334};
+
+static RTC_DateTypeDef log_date;
+static uint16_t log_day;         // 当天的日序号
+static uint16_t log_first_day;
+static uint32_t log_today;       // 当天步数（已累加到 step_base 为止）
+static uint32_t log_saved;       // 备份寄存器中的当天步数
+static uint16_t step_base;       // 已累加的 g_step 位置
+static uint32_t last_flush_tick;
+
+// 2000-01-01 起的天数，RTC 年份为 0 - 99
+static uint16_t StepLog_DayNumber(const RTC_DateTypeDef *date) {
+    uint16_t year = date->Year;
+    uint16_t day = year * 365 + (year + 3) / 4 + days_before_month[(date->Month - 1) % 12] +
+                   date->Date - 1;
+
+    if (date->Month > 2 && year % 4 == 0) {
+        day++;
+    }
+    return day;
+}
+
+static void StepLog_ReadDate(RTC_DateTypeDef *date) {
+    RTC_TimeTypeDef time;
+
+    // 与界面显示相同：日期保存在备份寄存器中，读取时间时才会跨日更新
+    read_bkup(&hrtc);
+    HAL_RTC_GetDate(&hrtc, date, RTC_FORMAT_BIN);
+    HAL_RTC_GetTime(&hrtc, &time, RTC_FORMAT_BIN);
+    write_bkup(&hrtc);
+}
+
+static uint32_t StepLog_ReadSlot(uint16_t day) {
+    uint32_t reg = STEP_LOG_BKP_SLOT(day % STEP_LOG_SLOTS);
+
+    return (HAL_RTCEx_BKUPRead(&hrtc, reg) & 0xFFFF) |
+           (HAL_RTCEx_BKUPRead(&hrtc, reg + 1) & 0xFFFF) << 16;
+}
+
+static void StepLog_WriteSlot(uint16_t day, uint32_t steps) {
+    uint32_t reg = STEP_LOG_BKP_SLOT(day % STEP_LOG_SLOTS);
+
+    HAL_RTCEx_BKUPWrite(&hrtc, reg, steps & 0xFFFF);
+    HAL_RTCEx_BKUPWrite(&hrtc, reg + 1, steps >> 16);
+}
+
+// g_step 由计步中断递增，按差值累加，16 位回绕不影响结果
+static void StepLog_Absorb(void) {
+    uint16_t step = g_step;
+
+    log_today += (uint16_t)(step - step_base);
+    step_base = step;
+}
+
+static void StepLog_Flush(void) {
+    StepLog_WriteSlot(log_day, log_today);
+    log_saved = log_today;
+    last_flush_tick = HAL_GetTick();
+}
+
+/**
+ * @brief 从头开始记录：清空所有槽，最后写入标志
+ */
+static void StepLog_Reset(uint16_t day) {
+    HAL_RTCEx_BKUPWrite(&hrtc, STEP_LOG_BKP_FLAG, 0);
+    for (uint16_t i = 0; i < STEP_LOG_SLOTS; i++) {
+        StepLog_WriteSlot(i, 0);
+    }
+    HAL_RTCEx_BKUPWrite(&hrtc, STEP_LOG_BKP_FIRST, day);
+    HAL_RTCEx_BKUPWrite(&hrtc, STEP_LOG_BKP_DAY, day);
+    HAL_RTCEx_BKUPWrite(&hrtc, STEP_LOG_BKP_FLAG, STEP_LOG_BKP_MAGIC);
+    log_first_day = day;
+    log_day = day;
+    log_today = 0;
+    log_saved = 0;
+}
+
+/**
+ * @brief 切换到新的一天：先清空新一天（以及关机期间跳过的日期）的槽，再更新当天日序号。
+ *        在两步之间复位时重新执行结果相同，旧一天的步数不会丢失或重复计入
+ */
+static void StepLog_Rollover(uint16_t day) {
+    uint16_t gap = day - log_day;
+
+    if (day < log_day) {
+        StepLog_Reset(day);  // 时钟被调回，已有记录属于"未来"的日期
+        return;
+    }
+    if (gap > STEP_LOG_SLOTS) {
+        gap = STEP_LOG_SLOTS;
+    }
+    for (uint16_t i = 0; i < gap; i++) {
+        StepLog_WriteSlot(day - i, 0);
+    }
+    HAL_RTCEx_BKUPWrite(&hrtc, STEP_LOG_BKP_DAY, day);
+    log_day = day;
+    log_today = 0;
+    log_saved = 0;
+}
+
+/**
+ * @brief 从备份寄存器恢复当天步数，关机期间跨日时完成切换，在开始计步之前调用
+ */
+void StepLog_Init(void) {
+    uint16_t day;
+
+    __HAL_RCC_BKP_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    StepLog_ReadDate(&log_date);
+    day = StepLog_DayNumber(&log_date);
+    step_base = g_step;
+    last_flush_tick = HAL_GetTick();
+    if (HAL_RTCEx_BKUPRead(&hrtc, STEP_LOG_BKP_FLAG) != STEP_LOG_BKP_MAGIC) {
+        StepLog_Reset(day);
+        return;
+    }
+    log_first_day = (uint16_t)HAL_RTCEx_BKUPRead(&hrtc, STEP_LOG_BKP_FIRST);
+    log_day = (uint16_t)HAL_RTCEx_BKUPRead(&hrtc, STEP_LOG_BKP_DAY);
+    log_today = StepLog_ReadSlot(log_day);
+    log_saved = log_today;
+    if (day != log_day) {
+        StepLog_Rollover(day);
+    }
+}
+
+/**
+ * @brief 当天步数，包含尚未保存到备份寄存器的部分
+ */
+uint32_t StepLog_GetToday(void) {
+    return log_today + (uint16_t)(g_step - step_base);
+}
+
+/**
+ * @brief 清零当天步数（按键操作），历史记录不受影响
+ */
+void StepLog_ClearToday(void) {
+    StepLog_Absorb();
+    log_today = 0;
+    StepLog_Flush();
+}
+
+void StepLog_GetSnapshot(StepLogSnapshot_t *snapshot) {
+    uint16_t days = log_day - log_first_day;
+
+    if (days > STEP_LOG_DAYS) {
+        days = STEP_LOG_DAYS;
+    }
+    snapshot->year = log_date.Year;
+    snapshot->month = log_date.Month;
+    snapshot->date = log_date.Date;
+    snapshot->today = StepLog_GetToday();
+    snapshot->days = (uint8_t)days;
+    for (uint16_t i = 0; i < STEP_LOG_DAYS; i++) {
+        snapshot->history[i] = (i < days) ? StepLog_ReadSlot(log_day - 1 - i) : 0;
+    }
+}
+
+/**
+ * @brief 步数记录任务：累加新步数，攒够一批或超时后保存，日期变化时切换到新的一天
+ */
+void Task_StepLog(void) {
+    RTC_DateTypeDef date;
+    uint16_t day;
+
+    StepLog_Absorb();
+    StepLog_ReadDate(&date);
+    day = StepLog_DayNumber(&date);
+    if (day != log_day) {
+        // 任务周期内午夜前后的步数全部计入前一天
+        if (log_today != log_saved) {
+            StepLog_Flush();
+        }
+        StepLog_Rollover(day);
+        last_flush_tick = HAL_GetTick();
+    }
+    log_date = date;
+    if (log_today - log_saved >= STEP_LOG_FLUSH_STEPS ||
+        (log_today != log_saved && HAL_GetTick() - last_flush_tick >= STEP_LOG_FLUSH_MS)) {
+        StepLog_Flush();
+    }
+}
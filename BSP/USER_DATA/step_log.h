@@ -0,0 +1,45 @@
+/**
+ * @file step_log.h
+ * @author Shiki
+ * @brief Daily step totals kept in the RTC backup domain.
+ *        g_step is the free-running counter incremented by the step engines; this module
+ *        accumulates its increments into today's total (32 bit) and checkpoints the total
+ *        into backup registers in batches, so a reset loses at most the last batch. The
+ *        RTC date selects the slot: at local midnight the next day's slot is cleared and
+ *        becomes today, leaving the previous days as a ring of daily totals.
+ * @version 0.1
+ * @date 2025-10-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __STEP_LOG_H
+#define __STEP_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STEP_LOG_DAYS 7                 // 保留的历史天数（不含当天）
+#define STEP_LOG_TASK_PERIOD_MS 1000    // 累加步数与检查日期的周期
+#define STEP_LOG_FLUSH_STEPS 64         // 未保存的步数达到该值时写备份寄存器
+#define STEP_LOG_FLUSH_MS (60UL * 1000) // 有未保存的步数时最长的保存间隔
+
+// 备份寄存器 DR12 - DR30（DR1 - DR11 由 RTC 日期与 IMU 校准使用）
+#define STEP_LOG_BKP_MAGIC 0x57E9
+
+typedef struct {
+    uint8_t year;   // 20xx
+    uint8_t month;
+    uint8_t date;
+    uint32_t today;                   // 当天步数
+    uint8_t days;                     // history 中有效的天数
+    uint32_t history[STEP_LOG_DAYS];  // history[0] 为昨天，依次向前
+} StepLogSnapshot_t;
+
+void StepLog_Init(void);
+uint32_t StepLog_GetToday(void);
+void StepLog_ClearToday(void);
+void StepLog_GetSnapshot(StepLogSnapshot_t *snapshot);
+void Task_StepLog(void);
+
+#endif
@@ -20,4 +20,6 @@ void UserData_UpdateHealth(void) {
              g_rtc_time.Hours, g_rtc_time.Minutes, g_rtc_time.Seconds);
     g_newest_user_hr_data.hr = g_heart_rate;
     g_newest_user_hr_data.spo2 = g_spo2;
+    g_newest_user_hr_data.pi = g_ppg_quality.pi;
+    g_newest_user_hr_data.sqi = g_ppg_quality.sqi;
 }
@@ -8,6 +8,8 @@ typedef struct {
     char time[20];
     int32_t hr;
     int32_t spo2;
+    uint16_t pi;  // 灌注指数，单位 0.01%
+    uint8_t sqi;  // 信号质量 0~100
 } UserHealthData;
 
 extern UserHealthData g_newest_user_hr_data;
@@ -61,6 +61,9 @@ void Error_Handler(void);
 #define KEY1_GPIO_Port GPIOE
 #define KEY0_Pin GPIO_PIN_4
 #define KEY0_GPIO_Port GPIOE
+#define MPU6050_INT_Pin GPIO_PIN_5
+#define MPU6050_INT_GPIO_Port GPIOE
+#define MPU6050_INT_EXTI_IRQn EXTI9_5_IRQn
 #define USER_KEY_Pin GPIO_PIN_0
 #define USER_KEY_GPIO_Port GPIOA
 #define OLED_RES_Pin GPIO_PIN_0
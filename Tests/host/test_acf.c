@@ -0,0 +1,137 @@
+/**
+ * @file test_acf.c
+ * @author Shiki
+ * @brief Replays synthetic PPG windows through the ACF and Maxim engines and compares their
+ *        heart rate errors against the generator's ground truth.
+ *        Each window is 5s at 100Hz like MAX30102_Calculate(): a two-peak pulse shape with
+ *        beat-to-beat jitter, respiratory baseline wander, a linear drift and white noise.
+ *        Red follows IR with a fixed AC/DC ratio, so both engines should also agree on SpO2.
+ * @version 0.1
+ * @date 2025-10-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <stdlib.h>
+
+#include "algorithm.h"
+#include "algorithm_acf.h"
+#include "trace.h"
+
+#define PPG_FS 100
+#define PPG_LEN 500
+#define PPG_WINDOWS 8             // 每种条件回放的窗口数
+#define ACF_HR_ERR_MAX 3.0        // 每种条件下 ACF 平均心率误差的上限 (bpm)
+#define ACF_HR_ERR_MARGIN 1.0     // ACF 平均误差最多比 Maxim 大的量 (bpm)
+#define ACF_VALID_PCT_MIN 90      // ACF 有效输出的最低比例
+#define SPO2_DIFF_MAX 3           // 两个引擎都有效时 SpO2 的最大差值 (%)
+
+typedef struct {
+    int hr;             // 心率 (bpm)
+    double perfusion;   // IR 的 AC/DC (%)
+    double noise;       // 噪声标准差，相对 AC 幅度
+    double dicrotic;    // 重搏波幅度，相对收缩峰
+} PpgCase_t;
+
+static uint32_t ir_buffer[PPG_LEN];
+static uint32_t red_buffer[PPG_LEN];
+
+// 一个心动周期内的波形：收缩峰与重搏波，phase 为 [0, 1)
+static double Ppg_Pulse(double phase, double dicrotic) {
+    double p1 = (phase - 0.25) / 0.08;
+    double p2 = (phase - 0.55) / 0.10;
+
+    return exp(-p1 * p1) + dicrotic * exp(-p2 * p2);
+}
+
+static void Ppg_Generate(const PpgCase_t *c) {
+    const double ir_dc = 100000.0, red_dc = 80000.0, ratio = 0.6;
+    double ir_ac = ir_dc * c->perfusion / 100.0;
+    double red_ac = red_dc * c->perfusion / 100.0 * ratio;
+    double phase = Trace_Uniform(), period = 60.0 / c->hr;
+    double drift = (Trace_Uniform() - 0.5) * 4.0 * ir_ac;
+
+    for (int i = 0; i < PPG_LEN; i++) {
+        double t = (double)i / PPG_FS;
+        double wander = 0.3 * sin(2.0 * TRACE_PI * 0.25 * t);
+        double pulse = Ppg_Pulse(phase, c->dicrotic) + wander + c->noise * Trace_Gauss();
+        // 血容量增加时反射光减弱，脉搏波形向下
+        double ir = ir_dc - ir_ac * pulse + drift * t / 5.0;
+        double red = red_dc - red_ac * pulse + drift * t / 5.0;
+
+        ir_buffer[i] = (uint32_t)ir;
+        red_buffer[i] = (uint32_t)red;
+        phase += 1.0 / (period * PPG_FS);
+        if (phase >= 1.0) {
+            phase -= 1.0;
+            period = 60.0 / c->hr * (1.0 + 0.03 * Trace_Gauss());
+        }
+    }
+}
+
+int main(void) {
+    static const PpgCase_t cases[] = {
+        {45, 2.0, 0.02, 0.1},  {60, 2.0, 0.02, 0.1},  {75, 2.0, 0.02, 0.1},
+        {90, 2.0, 0.02, 0.1},  {105, 2.0, 0.02, 0.1}, {120, 2.0, 0.02, 0.1},
+        {150, 2.0, 0.02, 0.1}, {180, 2.0, 0.02, 0.1}, {60, 0.5, 0.05, 0.1},
+        {90, 0.5, 0.05, 0.1},  {120, 0.5, 0.05, 0.1}, {75, 1.0, 0.15, 0.1},
+        {60, 2.0, 0.02, 0.4},  {90, 2.0, 0.02, 0.4},
+    };
+    double acf_err_sum = 0.0, maxim_err_sum = 0.0;
+    int acf_count = 0, maxim_count = 0, total = 0;
+
+    Trace_Seed(26);
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        const PpgCase_t *c = &cases[k];
+        double acf_err = 0.0, maxim_err = 0.0;
+        int acf_valid = 0, maxim_valid = 0;
+
+        for (int w = 0; w < PPG_WINDOWS; w++) {
+            int32_t acf_hr, acf_spo2, maxim_hr, maxim_spo2;
+            int8_t acf_hr_valid, acf_spo2_valid, maxim_hr_valid, maxim_spo2_valid;
+
+            Ppg_Generate(c);
+            acf_heart_rate_and_oxygen_saturation(ir_buffer, PPG_LEN, red_buffer, &acf_spo2,
+                                                 &acf_spo2_valid, &acf_hr, &acf_hr_valid);
+            maxim_heart_rate_and_oxygen_saturation(ir_buffer, PPG_LEN, red_buffer, &maxim_spo2,
+                                                   &maxim_spo2_valid, &maxim_hr,
+                                                   &maxim_hr_valid);
+            if (acf_hr_valid) {
+                acf_err += abs(acf_hr - c->hr);
+                acf_valid++;
+            }
+            if (maxim_hr_valid) {
+                maxim_err += abs(maxim_hr - c->hr);
+                maxim_valid++;
+            }
+            if (acf_spo2_valid && maxim_spo2_valid) {
+                TRACE_CHECK(abs(acf_spo2 - maxim_spo2) <= SPO2_DIFF_MAX,
+                            "hr %d: spo2 acf %d maxim %d", c->hr, (int)acf_spo2,
+                            (int)maxim_spo2);
+            }
+        }
+        printf("  hr %3d perf %.1f%% noise %.2f dicrotic %.1f: "
+               "acf %d/%d err %5.1f | maxim %d/%d err %5.1f\n",
+               c->hr, c->perfusion, c->noise, c->dicrotic, acf_valid, PPG_WINDOWS,
+               acf_valid ? acf_err / acf_valid : 0.0, maxim_valid, PPG_WINDOWS,
+               maxim_valid ? maxim_err / maxim_valid : 0.0);
+        TRACE_CHECK(acf_valid == 0 || acf_err / acf_valid <= ACF_HR_ERR_MAX, "hr %d: acf error",
+                    c->hr);
+        acf_err_sum += acf_err;
+        acf_count += acf_valid;
+        maxim_err_sum += maxim_err;
+        maxim_count += maxim_valid;
+        total += PPG_WINDOWS;
+    }
+
+    double acf_mean = acf_count ? acf_err_sum / acf_count : 1e9;
+    double maxim_mean = maxim_count ? maxim_err_sum / maxim_count : 1e9;
+
+    printf("  mean |hr error|: acf %.2f bpm (%d/%d valid), maxim %.2f bpm (%d/%d valid)\n",
+           acf_mean, acf_count, total, maxim_mean, maxim_count, total);
+    TRACE_CHECK(acf_count * 100 >= total * ACF_VALID_PCT_MIN, "acf valid %d/%d", acf_count,
+                total);
+    TRACE_CHECK(acf_mean <= maxim_mean + ACF_HR_ERR_MARGIN, "acf %.2f vs maxim %.2f bpm",
+                acf_mean, maxim_mean);
+    return Trace_Result("test_acf");
+}
@@ -0,0 +1,207 @@
+/**
+ * @file test_activity.c
+ * @author Shiki
+ * @brief Replays synthetic 200Hz accelerometer traces through the activity classifier.
+ *        Still, walking and running traces have a known class, cadence and magnitude
+ *        standard deviation; arm gestures and wrist shaking have no gait period and must be
+ *        reported as other. After the first evaluations settle, at least CLASS_MIN_PCT of the
+ *        results must carry the expected class, the cadence must stay within CADENCE_TOL_SPM
+ *        and the intensity within INTENSITY_TOL of the value implied by the trace amplitude.
+ * @version 0.1
+ * @date 2025-10-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <stdlib.h>
+
+#include "activity.h"
+#include "trace.h"
+
+#define IMU_LSB_PER_G 16384.0  // 参考格式 ±2g
+#define TRACE_SECONDS 30.0
+#define SETTLE_RESULTS 2       // 开头的结果窗口中含有起始段，不计入
+#define CLASS_MIN_PCT 90       // 分类正确的结果占比下限
+#define CADENCE_TOL_SPM 6      // 步频误差上限（步/分钟）
+#define INTENSITY_TOL 8        // 强度误差上限
+#define INTENSITY_FULL_MG 800  // 与 activity.c 相同：标准差达到该值时强度为 100
+#define HARMONIC 0.3           // 步态二次谐波相对基波的幅度
+
+typedef struct {
+    double roll, pitch;  // 手腕姿态 (rad)，缓慢漂移
+    uint32_t results;    // 计入的结果数
+    uint32_t hits[ACTIVITY_COUNT];
+    int32_t cadence_err_max;
+    int32_t intensity_min, intensity_max;
+} ActivityTrace_t;
+
+static void Trace_Begin(ActivityTrace_t *t) {
+    t->roll = 0.3;
+    t->pitch = 0.5;
+    t->results = 0;
+    for (int i = 0; i < ACTIVITY_COUNT; i++) {
+        t->hits[i] = 0;
+    }
+    t->cadence_err_max = 0;
+    t->intensity_min = 100;
+    t->intensity_max = 0;
+    activity_reset();
+}
+
+// 按当前姿态把幅值 g（单位 g）分解到三轴后送入分类器，统计每个新结果
+static void Trace_Push(ActivityTrace_t *t, double g, double cadence, uint32_t *seen) {
+    double lsb = g * IMU_LSB_PER_G;
+    ActivityResult_t r;
+    int32_t err;
+
+    t->roll += 0.002 * Trace_Gauss();
+    t->pitch += 0.002 * Trace_Gauss();
+    // 与固件相同：中断中入窗，任务中评估
+    activity_push(Trace_Clip16(lsb * sin(t->pitch)),
+                  Trace_Clip16(lsb * sin(t->roll) * cos(t->pitch)),
+                  Trace_Clip16(lsb * cos(t->roll) * cos(t->pitch)));
+    if (!activity_update() || ++*seen <= SETTLE_RESULTS) {
+        return;
+    }
+    activity_get(&r);
+    t->results++;
+    t->hits[r.e_class]++;
+    // 只在步态轨迹上统计步频误差
+    if (cadence > 0.0 && (r.e_class == ACTIVITY_WALK || r.e_class == ACTIVITY_RUN)) {
+        err = abs((int32_t)r.uw_cadence - (int32_t)lround(cadence));
+        if (err > t->cadence_err_max) {
+            t->cadence_err_max = err;
+        }
+    }
+    if (r.uch_intensity < t->intensity_min) {
+        t->intensity_min = r.uch_intensity;
+    }
+    if (r.uch_intensity > t->intensity_max) {
+        t->intensity_max = r.uch_intensity;
+    }
+}
+
+// 静止：只有传感器噪声
+static void Trace_Still(ActivityTrace_t *t, double noise) {
+    uint32_t seen = 0;
+
+    for (int i = 0; i < (int)(TRACE_SECONDS * ACTIVITY_INPUT_HZ); i++) {
+        Trace_Push(t, 1.0 + noise * Trace_Gauss(), 0.0, &seen);
+    }
+}
+
+// 步态：每步一个周期，基波 + 二次谐波，步频有 3% 的抖动
+static void Trace_Gait(ActivityTrace_t *t, double cadence, double amp, double noise) {
+    uint32_t seen = 0;
+    double ph = 0.0;
+
+    for (int i = 0; i < (int)(TRACE_SECONDS * ACTIVITY_INPUT_HZ); i++) {
+        ph += 2.0 * TRACE_PI * cadence / 60.0 * (1.0 + 0.03 * Trace_Gauss()) / ACTIVITY_INPUT_HZ;
+        Trace_Push(t, 1.0 + amp * sin(ph) + HARMONIC * amp * sin(2.0 * ph + 1.0) +
+                          noise * Trace_Gauss(),
+                   cadence, &seen);
+    }
+}
+
+// 抬手、翻腕等动作：间隔 0.3 - 1.5s，每次 0.2 - 0.6s、0.2 - 0.6g 的单峰
+static void Trace_Gesture(ActivityTrace_t *t) {
+    int total = (int)(TRACE_SECONDS * ACTIVITY_INPUT_HZ);
+    uint32_t seen = 0;
+    int i = 0;
+
+    while (i < total) {
+        int len = (int)((0.2 + 0.4 * Trace_Uniform()) * ACTIVITY_INPUT_HZ);
+        int pause = (int)((0.3 + 1.2 * Trace_Uniform()) * ACTIVITY_INPUT_HZ);
+        double amp = (Trace_Uniform() < 0.5 ? -1.0 : 1.0) * (0.2 + 0.4 * Trace_Uniform());
+
+        for (int k = 0; k < len && i < total; k++, i++) {
+            Trace_Push(t, 1.0 + amp * sin(TRACE_PI * k / len) + 0.02 * Trace_Gauss(), 0.0,
+                       &seen);
+        }
+        for (int k = 0; k < pause && i < total; k++, i++) {
+            Trace_Push(t, 1.0 + 0.02 * Trace_Gauss(), 0.0, &seen);
+        }
+    }
+}
+
+// 晃动手腕：5 - 9Hz、0.3 - 0.8g，在步频范围之外
+static void Trace_Shake(ActivityTrace_t *t) {
+    int total = (int)(TRACE_SECONDS * ACTIVITY_INPUT_HZ);
+    uint32_t seen = 0;
+    int i = 0;
+
+    while (i < total) {
+        int burst = (int)((1.0 + 3.0 * Trace_Uniform()) * ACTIVITY_INPUT_HZ);
+        double hz = 5.0 + 4.0 * Trace_Uniform(), amp = 0.3 + 0.5 * Trace_Uniform(), ph = 0.0;
+
+        for (int k = 0; k < burst && i < total; k++, i++) {
+            ph += 2.0 * TRACE_PI * hz * (1.0 + 0.05 * Trace_Gauss()) / ACTIVITY_INPUT_HZ;
+            Trace_Push(t, 1.0 + amp * sin(ph) + 0.02 * Trace_Gauss(), 0.0, &seen);
+        }
+    }
+}
+
+// 步态幅值标准差对应的强度：基波与二次谐波的方差之和
+static int32_t Gait_Intensity(double amp) {
+    double std_mg = amp * sqrt((1.0 + HARMONIC * HARMONIC) / 2.0) * 1000.0;
+
+    return std_mg >= INTENSITY_FULL_MG ? 100 : (int32_t)(std_mg * 100 / INTENSITY_FULL_MG);
+}
+
+static void Check_Class(const ActivityTrace_t *t, const char *name, Activity_t expect) {
+    printf("  %-28s still %2u walk %2u run %2u other %2u | cadence err %2d | intensity %d-%d\n",
+           name, (unsigned)t->hits[ACTIVITY_STILL], (unsigned)t->hits[ACTIVITY_WALK],
+           (unsigned)t->hits[ACTIVITY_RUN], (unsigned)t->hits[ACTIVITY_OTHER],
+           (int)t->cadence_err_max, (int)t->intensity_min, (int)t->intensity_max);
+    TRACE_CHECK(t->results > 0, "%s: no result", name);
+    TRACE_CHECK(t->hits[expect] * 100 >= CLASS_MIN_PCT * t->results, "%s: %u / %u as %s", name,
+                (unsigned)t->hits[expect], (unsigned)t->results, activity_name(expect));
+}
+
+int main(void) {
+    static const struct {
+        double cadence, amp;
+        Activity_t expect;
+    } gaits[] = {
+        {90, 0.15, ACTIVITY_WALK},  {110, 0.25, ACTIVITY_WALK}, {130, 0.35, ACTIVITY_WALK},
+        {160, 0.45, ACTIVITY_RUN},  {170, 0.60, ACTIVITY_RUN},  {150, 0.70, ACTIVITY_RUN},
+    };
+    ActivityTrace_t t;
+    char name[40];
+
+    Trace_Seed(43);
+    Trace_Begin(&t);
+    Trace_Still(&t, 0.005);
+    Check_Class(&t, "still", ACTIVITY_STILL);
+    TRACE_CHECK(t.intensity_max <= 1, "still: intensity %d", (int)t.intensity_max);
+
+    Trace_Begin(&t);
+    Trace_Still(&t, 0.015);
+    Check_Class(&t, "still, noisy", ACTIVITY_STILL);
+    TRACE_CHECK(t.intensity_max <= 2, "still, noisy: intensity %d", (int)t.intensity_max);
+
+    for (size_t g = 0; g < sizeof(gaits) / sizeof(gaits[0]); g++) {
+        int32_t expect = Gait_Intensity(gaits[g].amp);
+
+        snprintf(name, sizeof(name), "%s %3.0f spm amp %.2fg", activity_name(gaits[g].expect),
+                 gaits[g].cadence, gaits[g].amp);
+        Trace_Begin(&t);
+        Trace_Gait(&t, gaits[g].cadence, gaits[g].amp, 0.03);
+        Check_Class(&t, name, gaits[g].expect);
+        TRACE_CHECK(t.cadence_err_max <= CADENCE_TOL_SPM, "%s: cadence error %d spm", name,
+                    (int)t.cadence_err_max);
+        TRACE_CHECK(t.intensity_min >= expect - INTENSITY_TOL &&
+                        t.intensity_max <= expect + INTENSITY_TOL,
+                    "%s: intensity %d-%d, expected %d", name, (int)t.intensity_min,
+                    (int)t.intensity_max, (int)expect);
+    }
+
+    Trace_Begin(&t);
+    Trace_Gesture(&t);
+    Check_Class(&t, "gestures", ACTIVITY_OTHER);
+
+    Trace_Begin(&t);
+    Trace_Shake(&t);
+    Check_Class(&t, "wrist shaking", ACTIVITY_OTHER);
+    return Trace_Result("test_activity");
+}
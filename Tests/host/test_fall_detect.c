@@ -0,0 +1,309 @@
+/**
+ * @file test_fall_detect.c
+ * @author Shiki
+ * @brief Replays synthetic accelerometer traces through the fall detector at the rates and
+ *        ranges the IMU can be configured to.
+ *        Fall traces (free fall, impact, bounce, lying still in a new orientation) must give
+ *        exactly one detection per fall; running, sitting down hard, a jump, a stumble that
+ *        is caught, and a fall followed by getting up must give none. The same traces are
+ *        also replayed as if the IMU had been asleep in wake-on-motion mode from SLEEP_MS,
+ *        with the detector armed by fall_detect_resume(): once with sampling restarting at
+ *        the worst-case WAKE_LATENCY_MS after the action began (the free fall is missed),
+ *        and once with an earlier wake-up (WAKE_EARLY_MS before the action, e.g. the arm
+ *        moving before sitting down hard), where the whole action, impact included, is
+ *        replayed on the resumed path. The falls must still be caught and the others
+ *        rejected in both cases.
+ *        The per-sample cost is timed with the x86 time stamp counter. Each trace is replayed
+ *        CYCLE_REPEATS times and the cheapest run is kept, which removes interrupts and cache
+ *        misses: the mean cost per sample must stay within CYCLE_BUDGET, and the single
+ *        worst sample (the confirmation frame, which runs the square root) within
+ *        CYCLE_WORST_MAX, since one-sample timings still jitter on a shared host. The host
+ *        core retires more per cycle than the Cortex-M3, so this catches regressions such as
+ *        a loop on the per-sample path; the firmware checks the real count with the DWT
+ *        counter (fall_alert.c).
+ * @version 0.1
+ * @date 2025-10-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <stdlib.h>
+
+#include "fall_detect.h"
+#include "trace.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES_AVAILABLE 1
+#define CYCLES_READ() __rdtsc()
+#else
+#define CYCLES_AVAILABLE 0
+#define CYCLES_READ() 0
+#endif
+
+#define TRACE_SECONDS 24
+#define TRACE_MAX_RATE_HZ 1000
+#define TRACE_MAX_SAMPLES (TRACE_SECONDS * TRACE_MAX_RATE_HZ)
+#define FREEFALL_MS 300      // 合成跌倒的失重时间
+#define FREEFALL_TOL_MS 30   // 报告的失重时间的允许误差
+#define ACTION_MS 3000       // 所有场景的动作都从该时刻开始
+#define SLEEP_MS 2000        // 运动唤醒回放中 IMU 从该时刻起停止采样
+#define WAKE_EARLY_MS 100    // 提前唤醒回放中恢复采样早于动作的时间
+// 运动唤醒到恢复采集的最长时间（INT 未接线）：40Hz 唤醒采样 + 任务轮询运动标志最多一个周期
+// + 等待陀螺仪稳定的下一个周期 + 调度余量
+#define WOM_PERIOD_MS 25
+#define POWER_TASK_PERIOD_MS 100  // STEP_POWER_TASK_PERIOD_MS（step_count.h 依赖 HAL）
+#define WAKE_LATENCY_MS (WOM_PERIOD_MS + 2 * POWER_TASK_PERIOD_MS + 50)
+#define CYCLE_BUDGET 200     // FALL_ALERT_CYCLE_BUDGET（fall_alert.h 依赖 HAL，不在主机上包含）
+#define CYCLE_WORST_MAX (2 * CYCLE_BUDGET)
+#define CYCLE_REPEATS 64
+
+typedef enum {
+    SCENE_FALL = 0,     // 3s 处跌倒后躺着不动
+    SCENE_FALL_TWICE,   // 跌倒、躺下、起身行走，再次跌倒
+    SCENE_RUN,          // 2.5Hz、±0.9g 跑步
+    SCENE_SIT_HARD,     // 重重坐下：没有失重，2.8g 冲击
+    SCENE_JUMP,         // 跳起：200ms 失重，3g 落地后继续走
+    SCENE_STUMBLE,      // 绊倒后扶住：失重后没有冲击
+    SCENE_FALL_GETUP,   // 跌倒后 1.2s 内起身行走
+    SCENE_COUNT
+} Scene_t;
+
+static const char *const scene_names[SCENE_COUNT] = {
+    "fall", "fall twice", "run", "sit down hard", "jump", "stumble", "fall and get up",
+};
+static const uint8_t scene_falls[SCENE_COUNT] = {1, 2, 0, 0, 0, 0, 0};
+
+static int16_t trace_x[TRACE_MAX_SAMPLES], trace_y[TRACE_MAX_SAMPLES], trace_z[TRACE_MAX_SAMPLES];
+static uint32_t sample_cycles[TRACE_MAX_SAMPLES];
+
+// 跌倒：失重 -> 冲击 -> 反弹，返回 -1 表示 t 不在跌倒过程中
+static double Fall_Magnitude(double t, double start) {
+    double ff_end = start + FREEFALL_MS / 1000.0;
+
+    if (t < start || t >= ff_end + 0.5) {
+        return -1.0;
+    }
+    if (t < ff_end) {
+        return 0.15;
+    }
+    if (t < ff_end + 0.03) {
+        return 4.0;
+    }
+    return 1.0 + 0.8 * exp(-6.0 * (t - ff_end)) * sin(2.0 * TRACE_PI * 6.0 * (t - ff_end));
+}
+
+// 合成幅值（单位 g），lying 输出是否已躺下（姿态改变）
+static double Scene_Magnitude(Scene_t scene, double t, int *lying) {
+    double g;
+
+    switch (scene) {
+        case SCENE_FALL:
+            if ((g = Fall_Magnitude(t, 3.0)) >= 0.0) {
+                return g;
+            }
+            *lying = t >= 3.0;
+            return 1.0;
+        case SCENE_FALL_TWICE:
+            if ((g = Fall_Magnitude(t, 3.0)) >= 0.0 || (g = Fall_Magnitude(t, 15.0)) >= 0.0) {
+                return g;
+            }
+            *lying = (t >= 3.0 && t < 9.0) || t >= 15.0;
+            return (t >= 9.0 && t < 15.0) ? 1.0 + 0.4 * sin(2.0 * TRACE_PI * 1.8 * t) : 1.0;
+        case SCENE_RUN:
+            return 1.0 + 0.9 * sin(2.0 * TRACE_PI * 2.5 * t);
+        case SCENE_SIT_HARD:
+            return (t >= 3.0 && t < 3.05) ? 2.8 : 1.0;
+        case SCENE_JUMP:
+            if (t >= 3.0 && t < 3.2) {
+                return 0.1;
+            }
+            if (t >= 3.2 && t < 3.25) {
+                return 3.0;
+            }
+            return t >= 3.25 ? 1.0 + 0.6 * sin(2.0 * TRACE_PI * 2.0 * t) : 1.0;
+        case SCENE_STUMBLE:
+            if (t >= 3.0 && t < 3.15) {
+                return 0.3;
+            }
+            return (t >= 3.15 && t < 3.6) ? 1.0 + 0.4 * sin(2.0 * TRACE_PI * 3.0 * t) : 1.0;
+        case SCENE_FALL_GETUP:
+            if ((g = Fall_Magnitude(t, 3.0)) >= 0.0) {
+                return g;
+            }
+            return t >= 4.5 ? 1.0 + 0.5 * sin(2.0 * TRACE_PI * 2.0 * t) : 1.0;
+        default:
+            return 1.0;
+    }
+}
+
+// 生成轨迹，返回样本数；躺下后重力转到 X 轴
+static int Trace_Build(Scene_t scene, uint16_t rate_hz, uint16_t lsb_per_g) {
+    int n = TRACE_SECONDS * rate_hz;
+
+    for (int i = 0; i < n; i++) {
+        double t = (double)i / rate_hz;
+        int lying = 0;
+        double g = (Scene_Magnitude(scene, t, &lying) + 0.02 * Trace_Gauss()) * lsb_per_g;
+        double tilt = lying ? 1.4 : 0.4;
+
+        trace_x[i] = Trace_Clip16(g * sin(tilt));
+        trace_y[i] = Trace_Clip16(g * 0.2);
+        trace_z[i] = Trace_Clip16(g * cos(tilt));
+    }
+    return n;
+}
+
+// 回放一遍轨迹，返回检测到的跌倒次数
+static int Trace_Replay(FallDetect_t *st, int n, uint16_t rate_hz, uint16_t lsb_per_g,
+                        FallInfo_t *info) {
+    int events = 0;
+
+    fall_detect_init(st, rate_hz, lsb_per_g);
+    for (int i = 0; i < n; i++) {
+        events += fall_detect_update(st, trace_x[i], trace_y[i], trace_z[i], info);
+    }
+    return events;
+}
+
+// 运动唤醒：sleep 到 first 之间的样本没有采到，恢复采集时检测器从等待冲击开始
+static int Trace_ReplayResumed(FallDetect_t *st, int n, int sleep, int first, uint16_t rate_hz,
+                               uint16_t lsb_per_g, FallInfo_t *info) {
+    int events = 0;
+
+    fall_detect_init(st, rate_hz, lsb_per_g);
+    for (int i = 0; i < sleep; i++) {
+        events += fall_detect_update(st, trace_x[i], trace_y[i], trace_z[i], info);
+    }
+    fall_detect_resume(st);
+    for (int i = first; i < n; i++) {
+        events += fall_detect_update(st, trace_x[i], trace_y[i], trace_z[i], info);
+    }
+    return events;
+}
+
+// 逐个样本计时回放一遍，按样本记录最少的周期数
+static void Trace_TimeSamples(FallDetect_t *st, int n, uint16_t rate_hz, uint16_t lsb_per_g,
+                              FallInfo_t *info) {
+    fall_detect_init(st, rate_hz, lsb_per_g);
+    for (int i = 0; i < n; i++) {
+        uint64_t start = CYCLES_READ();
+        uint64_t cycles;
+
+        fall_detect_update(st, trace_x[i], trace_y[i], trace_z[i], info);
+        cycles = CYCLES_READ() - start;
+        if (cycles < sample_cycles[i]) {
+            sample_cycles[i] = (uint32_t)cycles;
+        }
+    }
+}
+
+// 计时开销：两次连续读取之间的最少周期数
+static uint32_t Cycles_Overhead(void) {
+    uint32_t best = UINT32_MAX;
+
+    for (int i = 0; i < 1000; i++) {
+        uint64_t start = CYCLES_READ();
+        uint64_t cycles = CYCLES_READ() - start;
+
+        if (cycles < best) {
+            best = (uint32_t)cycles;
+        }
+    }
+    return best;
+}
+
+int main(void) {
+    static const struct {
+        uint16_t rate_hz, lsb_per_g;
+    } configs[] = {{100, 8192}, {200, 4096}, {1000, 2048}, {200, 16384}};
+    uint32_t overhead = Cycles_Overhead(), worst = 0;
+    double mean_max = 0.0;
+    FallDetect_t st;
+    FallInfo_t info;
+
+    Trace_Seed(47);
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        uint16_t rate = configs[c].rate_hz, lsb = configs[c].lsb_per_g;
+        // 与 fall_detect_init 相同：量程不足时冲击阈值降到量程的 95%
+        uint32_t impact_min = 32767UL * 1000 / lsb * 95 / 100;
+
+        if (impact_min > FALL_IMPACT_MG) {
+            impact_min = FALL_IMPACT_MG;
+        }
+        for (int s = 0; s < SCENE_COUNT; s++) {
+            int n = Trace_Build((Scene_t)s, rate, lsb);
+            uint64_t best = UINT64_MAX;
+            int events;
+
+            info.uw_freefall_ms = 0;
+            info.uw_impact_mg = 0;
+            events = Trace_Replay(&st, n, rate, lsb, &info);
+            printf("  %4u Hz %5u LSB/g %-16s %d falls", rate, lsb, scene_names[s], events);
+            if (events != 0) {
+                printf(" (free fall %u ms, impact %u mg)", info.uw_freefall_ms,
+                       info.uw_impact_mg);
+            }
+            printf("\n");
+            TRACE_CHECK(events == scene_falls[s], "%u Hz %s: %d falls, expected %u", rate,
+                        scene_names[s], events, scene_falls[s]);
+            if (events != 0) {
+                TRACE_CHECK(abs((int)info.uw_freefall_ms - FREEFALL_MS) <= FREEFALL_TOL_MS,
+                            "%u Hz %s: free fall %u ms", rate, scene_names[s],
+                            info.uw_freefall_ms);
+                TRACE_CHECK(info.uw_impact_mg >= impact_min, "%u Hz %s: impact %u mg", rate,
+                            scene_names[s], info.uw_impact_mg);
+            }
+            events = Trace_ReplayResumed(&st, n, SLEEP_MS * rate / 1000,
+                                         (ACTION_MS + WAKE_LATENCY_MS) * rate / 1000, rate,
+                                         lsb, &info);
+            printf("  %4u Hz %5u LSB/g %-16s %d falls after a late wake-up\n", rate, lsb,
+                   scene_names[s], events);
+            TRACE_CHECK(events == scene_falls[s], "%u Hz %s after a late wake-up: %d falls",
+                        rate, scene_names[s], events);
+            events = Trace_ReplayResumed(&st, n, SLEEP_MS * rate / 1000,
+                                         (ACTION_MS - WAKE_EARLY_MS) * rate / 1000, rate, lsb,
+                                         &info);
+            printf("  %4u Hz %5u LSB/g %-16s %d falls after an early wake-up\n", rate, lsb,
+                   scene_names[s], events);
+            TRACE_CHECK(events == scene_falls[s], "%u Hz %s after an early wake-up: %d falls",
+                        rate, scene_names[s], events);
+            if (!CYCLES_AVAILABLE) {
+                continue;
+            }
+            for (int i = 0; i < n; i++) {
+                sample_cycles[i] = UINT32_MAX;
+            }
+            for (int r = 0; r < CYCLE_REPEATS; r++) {
+                uint64_t start = CYCLES_READ();
+                uint64_t cycles;
+
+                Trace_Replay(&st, n, rate, lsb, &info);
+                cycles = CYCLES_READ() - start;
+                if (cycles < best) {
+                    best = cycles;
+                }
+                Trace_TimeSamples(&st, n, rate, lsb, &info);
+            }
+            if ((double)best / n > mean_max) {
+                mean_max = (double)best / n;
+            }
+            for (int i = 0; i < n; i++) {
+                uint32_t cycles = sample_cycles[i] > overhead ? sample_cycles[i] - overhead : 0;
+
+                if (cycles > worst) {
+                    worst = cycles;
+                }
+            }
+        }
+    }
+    if (CYCLES_AVAILABLE) {
+        printf("  mean %.1f cycles per sample (budget %u), worst sample %u cycles (limit %u)\n",
+               mean_max, CYCLE_BUDGET, (unsigned)worst, CYCLE_WORST_MAX);
+        TRACE_CHECK(mean_max <= CYCLE_BUDGET, "mean %.1f cycles per sample", mean_max);
+        TRACE_CHECK(worst <= CYCLE_WORST_MAX, "worst sample %u cycles", (unsigned)worst);
+    } else {
+        printf("  no cycle counter on this host, cost not measured\n");
+    }
+    return Trace_Result("test_fall_detect");
+}
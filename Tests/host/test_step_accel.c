@@ -0,0 +1,134 @@
+/**
+ * @file test_step_accel.c
+ * @author Shiki
+ * @brief Replays synthetic 200Hz accelerometer traces through the magnitude step engine.
+ *        Walking traces have a known number of steps, with cadence jitter, a second
+ *        harmonic, white noise and a slowly drifting wrist orientation; the count must stay
+ *        within STEP_ERR_PCT of the truth. A still trace must count nothing, and a wrist
+ *        shaking trace (5 - 9Hz bursts with isolated bumps) at most SHAKE_FALSE_MAX steps.
+ * @version 0.1
+ * @date 2025-10-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <stdlib.h>
+
+#include "step_accel.h"
+#include "trace.h"
+
+#define IMU_LSB_PER_G 16384.0  // 参考格式 ±2g
+#define WALK_STEPS 200
+#define STEP_ERR_PCT 3          // 行走计步误差上限 (%)
+#define SHAKE_FALSE_MAX 4       // 晃动轨迹允许的误计步数
+
+typedef struct {
+    double roll, pitch;  // 手腕姿态 (rad)，缓慢漂移
+    StepAccel_t st;
+    uint32_t steps;
+} StepTrace_t;
+
+static void Trace_Begin(StepTrace_t *t) {
+    t->roll = 0.3;
+    t->pitch = 0.5;
+    t->steps = 0;
+    step_accel_init(&t->st);
+}
+
+// 按当前姿态把幅值 g（单位 g）分解到三轴后送入引擎
+static void Trace_Push(StepTrace_t *t, double g) {
+    double lsb = g * IMU_LSB_PER_G;
+
+    t->roll += 0.002 * Trace_Gauss();
+    t->pitch += 0.002 * Trace_Gauss();
+    t->steps += step_accel_update(&t->st, Trace_Clip16(lsb * sin(t->pitch)),
+                                  Trace_Clip16(lsb * sin(t->roll) * cos(t->pitch)),
+                                  Trace_Clip16(lsb * cos(t->roll) * cos(t->pitch)));
+}
+
+static void Trace_Still(StepTrace_t *t, double seconds, double noise) {
+    for (int i = 0; i < (int)(seconds * STEP_ACCEL_SAMPLE_HZ); i++) {
+        Trace_Push(t, 1.0 + noise * Trace_Gauss());
+    }
+}
+
+// 每步一个周期：基波 + 二次谐波，步间隔有 5% 的抖动
+static void Trace_Walk(StepTrace_t *t, int steps, double cadence, double amp, double noise) {
+    for (int s = 0; s < steps; s++) {
+        double period = 60.0 / cadence * (1.0 + 0.05 * Trace_Gauss());
+        int n = (int)(period * STEP_ACCEL_SAMPLE_HZ);
+
+        for (int i = 0; i < n; i++) {
+            double ph = 2.0 * TRACE_PI * i / n;
+
+            Trace_Push(t, 1.0 + amp * sin(ph) + 0.3 * amp * sin(2.0 * ph + 1.0) +
+                              noise * Trace_Gauss());
+        }
+    }
+}
+
+// 晃动手腕：5 - 9Hz、0.3 - 1g 的晃动持续 1 - 4s，间隔 0.5 - 3s，其间偶有间隔随机的单次冲击
+static void Trace_Shake(StepTrace_t *t, double seconds) {
+    int total = (int)(seconds * STEP_ACCEL_SAMPLE_HZ);
+    int i = 0;
+
+    while (i < total) {
+        int burst = (int)((1.0 + 3.0 * Trace_Uniform()) * STEP_ACCEL_SAMPLE_HZ);
+        int pause = (int)((0.5 + 2.5 * Trace_Uniform()) * STEP_ACCEL_SAMPLE_HZ);
+        double hz = 5.0 + 4.0 * Trace_Uniform(), amp = 0.3 + 0.7 * Trace_Uniform(), ph = 0.0;
+
+        for (int k = 0; k < burst && i < total; k++, i++) {
+            ph += 2.0 * TRACE_PI * hz * (1.0 + 0.05 * Trace_Gauss()) / STEP_ACCEL_SAMPLE_HZ;
+            Trace_Push(t, 1.0 + amp * sin(ph) + 0.02 * Trace_Gauss());
+        }
+        for (int k = 0; k < pause && i < total; k++, i++) {
+            double g = 1.0 + 0.02 * Trace_Gauss();
+
+            // 平均每 2s 一次 100ms 的冲击
+            if (k + 20 < pause && Trace_Uniform() < 1.0 / (2 * STEP_ACCEL_SAMPLE_HZ)) {
+                for (int m = 0; m < 20 && i < total; m++, k++, i++) {
+                    Trace_Push(t, g + 0.8 * sin(TRACE_PI * m / 20));
+                }
+                continue;
+            }
+            Trace_Push(t, g);
+        }
+    }
+}
+
+int main(void) {
+    static const double cadences[] = {70, 100, 120, 140, 170};
+    static const double amps[] = {0.1, 0.25, 0.5};
+    static const double noises[] = {0.01, 0.03};
+    StepTrace_t t;
+
+    Trace_Seed(40);
+    for (size_t c = 0; c < sizeof(cadences) / sizeof(cadences[0]); c++) {
+        for (size_t a = 0; a < sizeof(amps) / sizeof(amps[0]); a++) {
+            for (size_t n = 0; n < sizeof(noises) / sizeof(noises[0]); n++) {
+                int err;
+
+                Trace_Begin(&t);
+                Trace_Still(&t, 3.0, noises[n]);
+                Trace_Walk(&t, WALK_STEPS, cadences[c], amps[a], noises[n]);
+                Trace_Still(&t, 4.0, noises[n]);
+                err = (int)t.steps - WALK_STEPS;
+                printf("  walk %3.0f spm amp %.2fg noise %.2fg: %u / %d steps\n", cadences[c],
+                       amps[a], noises[n], (unsigned)t.steps, WALK_STEPS);
+                TRACE_CHECK(abs(err) * 100 <= STEP_ERR_PCT * WALK_STEPS,
+                            "walk %.0f spm amp %.2f: error %d steps", cadences[c], amps[a], err);
+            }
+        }
+    }
+
+    Trace_Begin(&t);
+    Trace_Still(&t, 60.0, 0.01);
+    printf("  still 60s: %u steps\n", (unsigned)t.steps);
+    TRACE_CHECK(t.steps == 0, "still: %u steps", (unsigned)t.steps);
+
+    Trace_Begin(&t);
+    Trace_Shake(&t, 60.0);
+    printf("  shake 60s: %u steps\n", (unsigned)t.steps);
+    TRACE_CHECK(t.steps <= SHAKE_FALSE_MAX, "shake: %u steps", (unsigned)t.steps);
+    return Trace_Result("test_step_accel");
+}
@@ -0,0 +1,72 @@
+/**
+ * @file trace.h
+ * @author Shiki
+ * @brief Helpers shared by the host replay tests.
+ *        The traces are synthetic: each test generates its own signals from a fixed seed, so
+ *        the results are reproducible and no recorded data has to be committed. A failed
+ *        check prints the location and makes the test exit with a nonzero status.
+ * @version 0.1
+ * @date 2025-10-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TRACE_PI 3.14159265358979323846
+
+static uint32_t trace_seed = 1;
+static int trace_failures;
+
+// 固定种子的线性同余发生器，与主机 libc 的 rand() 无关，各平台结果一致
+static inline void Trace_Seed(uint32_t seed) {
+    trace_seed = seed;
+}
+
+// [0, 1) 均匀分布
+static inline double Trace_Uniform(void) {
+    trace_seed = trace_seed * 1103515245u + 12345u;
+    return (double)(trace_seed >> 8) / 16777216.0;
+}
+
+// 标准正态分布（Box-Muller）
+static inline double Trace_Gauss(void) {
+    double u = Trace_Uniform() + 1.0 / 33554432.0;
+    double v = Trace_Uniform();
+
+    return sqrt(-2.0 * log(u)) * cos(2.0 * TRACE_PI * v);
+}
+
+// 饱和转换为 16 位原始值
+static inline int16_t Trace_Clip16(double value) {
+    if (value > 32767.0) {
+        return 32767;
+    }
+    if (value < -32768.0) {
+        return -32768;
+    }
+    return (int16_t)lround(value);
+}
+
+#define TRACE_CHECK(cond, ...)                                             \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            printf("  FAIL %s:%d: ", __FILE__, __LINE__);                  \
+            printf(__VA_ARGS__);                                           \
+            printf("\n");                                                  \
+            trace_failures++;                                              \
+        }                                                                  \
+    } while (0)
+
+// 在 main() 末尾返回
+static inline int Trace_Result(const char *name) {
+    printf("%s: %s\n", name, trace_failures == 0 ? "PASS" : "FAIL");
+    return trace_failures == 0 ? 0 : 1;
+}
+
+#endif /* __TRACE_H */